@@ -1,4 +1,9 @@
 #include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <optional>
+#include <charconv>
+#include <numeric>
 
 #include "acmacs-base/string-join.hh"
 #include "hidb-5/hidb-bin.hh"
@@ -22,17 +27,320 @@ bool hidb::bin::has_signature(const char* data)
 
 // ----------------------------------------------------------------------
 
-std::string hidb::bin::Antigen::name() const
+std::string hidb::bin::sections_signature()
+{
+    return {"HIDBSECT", 8};
+
+} // hidb::bin::sections_signature
+
+// ----------------------------------------------------------------------
+
+size_t hidb::bin::sections_offset(const char* data)
+{
+    const auto tables = hidb::bin::tables(data);
+    auto offset = static_cast<size_t>(tables.first() - data) + tables.index()[tables.size()]; // end of the last table
+      // sections header starts at 8
+    if (offset % 8)
+        offset += 8 - offset % 8;
+    return offset;
+
+} // hidb::bin::sections_offset
+
+// ----------------------------------------------------------------------
+
+hidb::bin::Fingerprint hidb::bin::fingerprint(const char* data)
+{
+      // records are not hashed (hundreds of megabytes), any change in their sizes moves the offsets
+    std::string key(data, sizeof(Header));
+    const auto add_offsets = [&key](const auto& part) { key.append(reinterpret_cast<const char*>(part.index()), sizeof(ast_offset_t) * (part.size() + 1)); };
+    add_offsets(antigens(data));
+    add_offsets(sera(data));
+    add_offsets(tables(data));
+    return {sections_offset(data), hash(key)};
+
+} // hidb::bin::fingerprint
+
+// ----------------------------------------------------------------------
+
+const hidb::bin::SectionsHeader* hidb::bin::sections(const char* data, size_t data_size)
+{
+    const auto offset = sections_offset(data);
+    const std::string sig = sections_signature();
+    if ((offset + sizeof(SectionsHeader)) <= data_size && !std::memcmp(data + offset, sig.data(), sig.size()))
+        return reinterpret_cast<const SectionsHeader*>(data + offset);
+    else
+        return nullptr;
+
+} // hidb::bin::sections
+
+// ----------------------------------------------------------------------
+
+std::vector<hidb::bin::antigen_index_t> hidb::bin::reference_antigens(const char* data, const Table& aTable, const Strings& aStrings)
+{
+      // antigens with names (without annotations and reassortant) that match serum name (without annotations and reassortant) in the same table are reference
+      // there is minor possibility that test antigen with the same name present, it becomes false positive
+      // names are prefixed with virus type as hidb::Antigen::name() and hidb::Serum::name() do (cdc antigen names are not prefixed)
+    const auto antigens = bin::antigens(data);
+    const auto sera = bin::sera(data);
+    const std::string prefix = std::string{reinterpret_cast<const Header*>(data)->virus_type()} + "/";
+
+    std::vector<std::string> serum_names(aTable.number_of_sera());
+    std::transform(aTable.serum_begin(), aTable.serum_end(), serum_names.begin(), [&sera, &prefix, &aStrings](serum_index_t serum_index) { return prefix + sera[serum_index].name(aStrings); });
+    std::sort(serum_names.begin(), serum_names.end());
+
+    std::vector<antigen_index_t> result;
+    for (const auto* antigen_index = aTable.antigen_begin(); antigen_index != aTable.antigen_end(); ++antigen_index) {
+        const auto& antigen = antigens[*antigen_index];
+        if (std::binary_search(serum_names.begin(), serum_names.end(), antigen.cdc_name() ? antigen.name(aStrings) : prefix + antigen.name(aStrings)))
+            result.push_back(*antigen_index);
+    }
+    return result;
+
+} // hidb::bin::reference_antigens
+
+// ----------------------------------------------------------------------
+
+std::string hidb::bin::reference_antigens_section(const char* data, const Strings& aStrings)
+{
+    const auto tables = bin::tables(data);
+    std::vector<uint32_t> offsets(tables.size() + 1, 0);
+    std::vector<antigen_index_t> antigen_indexes;
+    for (size_t table_no = 0; table_no < tables.size(); ++table_no) {
+        const auto reference = reference_antigens(data, tables[table_no], aStrings);
+        antigen_indexes.insert(antigen_indexes.end(), reference.begin(), reference.end());
+        offsets[table_no + 1] = static_cast<uint32_t>(antigen_indexes.size());
+    }
+    std::string result(reinterpret_cast<const char*>(offsets.data()), sizeof(uint32_t) * offsets.size());
+    result.append(reinterpret_cast<const char*>(antigen_indexes.data()), sizeof(antigen_index_t) * antigen_indexes.size());
+    return result;
+
+} // hidb::bin::reference_antigens_section
+
+// ----------------------------------------------------------------------
+
+std::string hidb::bin::table_groups_section(const char* data, const Strings& aStrings)
+{
+    const auto tables = bin::tables(data);
+    const auto key = [&aStrings](const Table& table) { return std::string{table.lab(aStrings)} + ':' + std::string{table.assay(aStrings)} + ':' + std::string{table.rbc(aStrings)}; };
+
+    std::vector<std::pair<std::string, table_index_t>> groups; // key, first table
+    for (size_t table_no = 0; table_no < tables.size(); ++table_no)
+        groups.emplace_back(key(tables[table_no]), static_cast<table_index_t>(table_no));
+    std::sort(groups.begin(), groups.end());
+    groups.erase(std::unique(groups.begin(), groups.end(), [](const auto& e1, const auto& e2) { return e1.first == e2.first; }), groups.end());
+
+    std::vector<uint32_t> data_of_section(1 + groups.size() + tables.size());
+    data_of_section[0] = static_cast<uint32_t>(groups.size());
+    std::transform(groups.begin(), groups.end(), data_of_section.begin() + 1, [](const auto& group) { return group.second; });
+    for (size_t table_no = 0; table_no < tables.size(); ++table_no) {
+        const auto found = std::lower_bound(groups.begin(), groups.end(), key(tables[table_no]), [](const auto& group, const auto& look_for) { return group.first < look_for; });
+        data_of_section[1 + groups.size() + table_no] = static_cast<uint32_t>(found - groups.begin());
+    }
+    return std::string(reinterpret_cast<const char*>(data_of_section.data()), sizeof(uint32_t) * data_of_section.size());
+
+} // hidb::bin::table_groups_section
+
+// ----------------------------------------------------------------------
+
+template <typename AgSr> static std::string make_trigrams_section(const hidb::bin::Part<AgSr>& aPart, const hidb::bin::Strings& aStrings)
+{
+    std::vector<std::pair<hidb::bin::trigram_t, uint32_t>> entries; // trigram, record index
+    for (size_t no = 0; no < aPart.size(); ++no) {
+        const auto& rec = aPart[no];
+        hidb::bin::for_each_trigram(hidb::bin::similarity_key(rec.location(aStrings), rec.isolation(), rec.year()), [&entries, no](hidb::bin::trigram_t trigram) { entries.emplace_back(trigram, static_cast<uint32_t>(no)); });
+    }
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+    std::vector<hidb::bin::trigram_t> trigrams;
+    std::vector<uint32_t> offsets, records(entries.size());
+    for (size_t no = 0; no < entries.size(); ++no) {
+        if (trigrams.empty() || trigrams.back() != entries[no].first) {
+            trigrams.push_back(entries[no].first);
+            offsets.push_back(static_cast<uint32_t>(no));
+        }
+        records[no] = entries[no].second;
+    }
+    offsets.push_back(static_cast<uint32_t>(entries.size()));
+
+    const auto number_of_trigrams = static_cast<uint32_t>(trigrams.size());
+    std::string result(reinterpret_cast<const char*>(&number_of_trigrams), sizeof(number_of_trigrams));
+    result.append(reinterpret_cast<const char*>(trigrams.data()), sizeof(hidb::bin::trigram_t) * trigrams.size());
+    result.append(reinterpret_cast<const char*>(offsets.data()), sizeof(uint32_t) * offsets.size());
+    result.append(reinterpret_cast<const char*>(records.data()), sizeof(uint32_t) * records.size());
+    return result;
+
+} // make_trigrams_section
+
+std::string hidb::bin::antigen_trigrams_section(const char* data, const Strings& aStrings)
+{
+    return make_trigrams_section(bin::antigens(data), aStrings);
+
+} // hidb::bin::antigen_trigrams_section
+
+std::string hidb::bin::serum_trigrams_section(const char* data, const Strings& aStrings)
+{
+    return make_trigrams_section(bin::sera(data), aStrings);
+
+} // hidb::bin::serum_trigrams_section
+
+// ----------------------------------------------------------------------
+
+template <typename AgSr> static std::string make_completions_section(const hidb::bin::Part<AgSr>& aPart, const hidb::bin::Strings& aStrings)
+{
+    using Completions = hidb::bin::Completions;
+
+    std::vector<std::pair<std::string, uint32_t>> names(aPart.size()); // name, record index
+    for (size_t no = 0; no < aPart.size(); ++no)
+        names[no] = {aPart[no].name(aStrings), static_cast<uint32_t>(no)};
+    std::sort(names.begin(), names.end());
+
+    std::vector<std::string_view> distinct;
+    std::vector<uint32_t> number_of_tables, first;
+    std::vector<hidb::bin::table_index_t> tables;
+    for (auto name = names.begin(); name != names.end();) {
+        const std::string_view text{name->first};
+        distinct.push_back(text);
+        first.push_back(name->second);
+        tables.clear();
+        for (; name != names.end() && name->first == text; ++name) {
+            const auto [num_tables, table_indexes] = aPart[name->second].tables();
+            tables.insert(tables.end(), table_indexes, table_indexes + num_tables);
+        }
+        std::sort(tables.begin(), tables.end());
+        number_of_tables.push_back(static_cast<uint32_t>(std::unique(tables.begin(), tables.end()) - tables.begin()));
+    }
+
+    const auto better = [&number_of_tables](uint32_t c1, uint32_t c2) { return number_of_tables[c1] == number_of_tables[c2] ? c1 < c2 : number_of_tables[c1] > number_of_tables[c2]; };
+
+      // names sharing a prefix are consecutive, if no prefix of some length is shared by more than scan_limit names, no longer prefix is
+    std::vector<Completions::Prefix> prefixes;
+    std::vector<uint32_t> candidates;
+    for (size_t length = 0, found = 1; found > 0; ++length) {
+        found = 0;
+        for (size_t first_no = 0; first_no < distinct.size();) {
+            const auto prefix = distinct[first_no].substr(0, length);
+            auto last_no = first_no + 1;
+            while (last_no < distinct.size() && distinct[last_no].substr(0, length) == prefix)
+                ++last_no;
+            if (prefix.size() == length && (last_no - first_no) > Completions::scan_limit) {
+                candidates.resize(last_no - first_no);
+                std::iota(candidates.begin(), candidates.end(), static_cast<uint32_t>(first_no));
+                std::partial_sort(candidates.begin(), candidates.begin() + Completions::top_size, candidates.end(), better);
+                Completions::Prefix entry{static_cast<uint32_t>(first_no), static_cast<uint32_t>(length), {}};
+                std::copy_n(candidates.begin(), Completions::top_size, entry.top);
+                prefixes.push_back(entry);
+                ++found;
+            }
+            first_no = last_no;
+        }
+    }
+    std::sort(prefixes.begin(), prefixes.end(), [&distinct](const auto& p1, const auto& p2) { return distinct[p1.first].substr(0, p1.length) < distinct[p2.first].substr(0, p2.length); });
+
+    std::vector<uint32_t> header_and_offsets{static_cast<uint32_t>(distinct.size()), static_cast<uint32_t>(prefixes.size()), 0};
+    std::string characters;
+    for (const auto& name : distinct) {
+        characters.append(name);
+        header_and_offsets.push_back(static_cast<uint32_t>(characters.size()));
+    }
+
+    std::string result(reinterpret_cast<const char*>(header_and_offsets.data()), sizeof(uint32_t) * header_and_offsets.size());
+    result.append(reinterpret_cast<const char*>(number_of_tables.data()), sizeof(uint32_t) * number_of_tables.size());
+    result.append(reinterpret_cast<const char*>(first.data()), sizeof(uint32_t) * first.size());
+    result.append(reinterpret_cast<const char*>(prefixes.data()), sizeof(Completions::Prefix) * prefixes.size());
+    result.append(characters);
+    return result;
+
+} // make_completions_section
+
+std::string hidb::bin::antigen_completions_section(const char* data, const Strings& aStrings)
+{
+    return make_completions_section(bin::antigens(data), aStrings);
+
+} // hidb::bin::antigen_completions_section
+
+std::string hidb::bin::serum_completions_section(const char* data, const Strings& aStrings)
+{
+    return make_completions_section(bin::sera(data), aStrings);
+
+} // hidb::bin::serum_completions_section
+
+// ----------------------------------------------------------------------
+
+std::vector<size_t> hidb::bin::Completions::top(std::string_view aPrefix, size_t aNumber) const
+{
+    std::vector<size_t> result;
+    aNumber = std::min(aNumber, top_size); // just top_size completions are ranked for prefixes shared by many names, no scanning of them
+    const auto prefix_of = [this](const Prefix& prefix) { return name(prefix.first).substr(0, prefix.length); };
+    const auto* found = std::lower_bound(prefixes_, prefixes_ + number_of_prefixes_, aPrefix, [&prefix_of](const Prefix& prefix, std::string_view look_for) { return prefix_of(prefix) < look_for; });
+    if (found != prefixes_ + number_of_prefixes_ && prefix_of(*found) == aPrefix) {
+        result.assign(found->top, found->top + aNumber);
+        return result;
+    }
+
+      // prefix is shared by at most scan_limit names
+    size_t first = 0, last = number_of_;
+    while (first < last) {
+        const auto middle = first + (last - first) / 2;
+        if (name(middle) < aPrefix)
+            first = middle + 1;
+        else
+            last = middle;
+    }
+    for (last = first; last < number_of_ && name(last).substr(0, aPrefix.size()) == aPrefix; ++last)
+        result.push_back(last);
+    const auto better = [this](size_t c1, size_t c2) { return number_of_tables_[c1] == number_of_tables_[c2] ? c1 < c2 : number_of_tables_[c1] > number_of_tables_[c2]; };
+    if (result.size() > aNumber) {
+        std::partial_sort(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(aNumber), result.end(), better);
+        result.resize(aNumber);
+    }
+    else
+        std::sort(result.begin(), result.end(), better);
+    return result;
+
+} // hidb::bin::Completions::top
+
+// ----------------------------------------------------------------------
+
+std::pair<size_t, size_t> hidb::bin::LocationTree::find(std::string_view aLocation) const
+{
+    char look_for[LocationNode::location_size] = {};
+    std::memmove(look_for, aLocation.data(), std::min(aLocation.size(), sizeof(look_for)));
+
+      // k ends up as the node after the path of "less" turns, i.e. lower bound in the sorted order
+    size_t node = 1;
+    while (node <= number_of_) {
+        __builtin_prefetch(nodes_ + node * 4); // two levels below, 4 nodes are in 2 cache lines
+        node = 2 * node + static_cast<size_t>(std::memcmp(nodes_[node].location, look_for, sizeof(look_for)) < 0);
+    }
+    node >>= __builtin_ffsll(static_cast<long long>(~node));
+    if (node == 0 || std::memcmp(nodes_[node].location, look_for, sizeof(look_for)) != 0)
+        return {0, 0};
+    return {nodes_[node].first, nodes_[node].last};
+
+} // hidb::bin::LocationTree::find
+
+// ----------------------------------------------------------------------
+
+std::string hidb::bin::Antigen::name(const Strings& aStrings) const
 {
     if (!cdc_name())
-        return acmacs::string::join(acmacs::string::join_slash, host(), location(), isolation(), year_fast());
+        return acmacs::string::join(acmacs::string::join_slash, host(aStrings), location(aStrings), isolation(), year_fast());
     else
-        return acmacs::string::join(acmacs::string::join_space, location(), isolation()); // cdc name
+        return acmacs::string::join(acmacs::string::join_space, location(aStrings), isolation()); // cdc name
 
 } // hidb::bin::Antigen::name
 
 // ----------------------------------------------------------------------
 
+std::string hidb::bin::Antigen::full_name(const Strings& aStrings) const
+{
+    return acmacs::string::join(acmacs::string::join_space, name(aStrings), acmacs::string::join(acmacs::string::join_space, annotations()), reassortant(), passage(aStrings));
+
+} // hidb::bin::Antigen::full_name
+
+// ----------------------------------------------------------------------
+
 hidb::bin::date_t hidb::bin::Antigen::make_date(std::string_view aDate)
 {
     std::string compacted;
@@ -81,10 +389,10 @@ std::string hidb::bin::Antigen::date(bool compact) const
 std::vector<std::string_view> hidb::bin::Antigen::lab_ids() const
 {
     std::vector<std::string_view> result;
-    for (size_t no = 0; no < sizeof(lab_id_offset); ++no) {
+    for (size_t no = 0; no < std::size(lab_id_offset); ++no) {
           // ignore padding after lab id
         const auto* start = _start() + lab_id_offset[no];
-        auto* end = _start() + lab_id_offset[no+1];
+        auto* end = _start() + lab_id_end(no);
         while (end > start && !end[-1])
             --end;
         if (end > start)
@@ -94,6 +402,22 @@ std::vector<std::string_view> hidb::bin::Antigen::lab_ids() const
 
 } // hidb::bin::Antigen::lab_ids
 
+// ----------------------------------------------------------------------
+
+bool hidb::bin::Antigen::has_lab_id(std::string_view aLabId) const
+{
+    for (size_t no = 0; no < std::size(lab_id_offset); ++no) {
+        const auto* start = _start() + lab_id_offset[no];
+        auto* end = _start() + lab_id_end(no);
+        while (end > start && !end[-1])
+            --end;
+        if (end > start && std::string_view(start, static_cast<size_t>(end - start)) == aLabId)
+            return true;
+    }
+    return false;
+
+} // hidb::bin::Antigen::has_lab_id
+
 #ifndef __clang__
 #pragma GCC pop_options
 #endif
@@ -109,29 +433,208 @@ std::vector<std::string_view> hidb::bin::Antigen::lab_ids() const
 std::vector<std::string_view> hidb::bin::Antigen::annotations() const
 {
     std::vector<std::string_view> result;
-    for (size_t no = 0; no < sizeof(annotation_offset); ++no) {
-        if (const auto size = annotation_offset[no+1] - annotation_offset[no]; size > 0)
+    for (size_t no = 0; no < std::size(annotation_offset); ++no) {
+        if (const auto size = annotation_end(no) - annotation_offset[no]; size > 0)
             result.emplace_back(_start() + annotation_offset[no], static_cast<size_t>(size));
     }
     return result;
 
 } // hidb::bin::Antigen::annotations
 
+// ----------------------------------------------------------------------
+
+namespace
+{
+      // matches text against pieces joined the way acmacs::string::join does (empty pieces are skipped), used instead of comparing with full_name()
+    class joined_matcher
+    {
+     public:
+        joined_matcher(std::string_view aText) : text_{aText} {}
+
+        joined_matcher& operator()(std::string_view aPiece, char aSeparator)
+            {
+                if (matches_ && !aPiece.empty()) {
+                    if (started_) {
+                        if (text_.empty() || text_.front() != aSeparator) {
+                            matches_ = false;
+                            return *this;
+                        }
+                        text_.remove_prefix(1);
+                    }
+                    matches_ = text_.substr(0, aPiece.size()) == aPiece;
+                    text_.remove_prefix(std::min(aPiece.size(), text_.size()));
+                    started_ = true;
+                }
+                return *this;
+            }
+
+        bool matched() const { return matches_ && text_.empty(); }
+
+     private:
+        std::string_view text_;
+        bool matches_ = true;
+        bool started_ = false;
+    };
+
+} // namespace
+
+bool hidb::bin::Antigen::has_full_name(std::string_view aFullName, const Strings& aStrings) const
+{
+    joined_matcher match{aFullName};
+    if (!cdc_name())
+        match(host(aStrings), '/')(location(aStrings), '/')(isolation(), '/')(year_fast(), '/'); // name is the first piece, no separator before it
+    else
+        match(location(aStrings), ' ')(isolation(), ' ');
+    for (size_t no = 0; no < std::size(annotation_offset); ++no) {
+        if (const auto size = annotation_end(no) - annotation_offset[no]; size > 0)
+            match({_start() + annotation_offset[no], static_cast<size_t>(size)}, ' ');
+    }
+    return match(reassortant(), ' ')(passage(aStrings), ' ').matched();
+
+} // hidb::bin::Antigen::has_full_name
+
 #ifndef __clang__
 #pragma GCC pop_options
 #endif
 
 // ----------------------------------------------------------------------
 
-std::string hidb::bin::Serum::name() const
+hidb::bin::TableDate hidb::bin::TableDate::make(std::string_view aDate)
+{
+    const auto number = [](std::string_view text) -> std::optional<uint32_t> {
+        uint32_t value = 0;
+        if (const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value); ec == std::errc{} && end == text.data() + text.size() && !text.empty())
+            return value;
+        return std::nullopt;
+    };
+
+    TableDate result{0, 0};
+    const auto dot = aDate.find('.');
+    if (const auto date = number(aDate.substr(0, dot)); date.has_value() && aDate.substr(0, dot).size() == 8) {
+        result.date = *date;
+        if (dot != std::string_view::npos) {
+            if (const auto sequence = number(aDate.substr(dot + 1)); sequence.has_value())
+                result.sequence = *sequence;
+        }
+    }
+    return result;
+
+} // hidb::bin::TableDate::make
+
+// ----------------------------------------------------------------------
+
+hidb::bin::titer_t hidb::bin::titer_t::make(type_t aType, double aLogged)
+{
+    const auto raw = std::clamp(std::lround(aLogged * logged_scale) + logged_bias, 0L, static_cast<long>(logged_mask));
+    return titer_t{static_cast<uint16_t>((static_cast<uint16_t>(aType) << type_shift) | static_cast<uint16_t>(raw))};
+
+} // hidb::bin::titer_t::make
+
+// ----------------------------------------------------------------------
+
+hidb::bin::titer_t hidb::bin::titer_t::from_value(type_t aType, size_t aValue)
+{
+      // most titers are 10 * 2^n, avoid log2 for them
+    if (const auto steps = aValue / 10; steps > 0 && (aValue % 10) == 0 && (steps & (steps - 1)) == 0) {
+        int power = 0;
+        for (auto val = steps; val > 1; val >>= 1)
+            ++power;
+        return titer_t{static_cast<uint16_t>((static_cast<uint16_t>(aType) << type_shift) | static_cast<uint16_t>(power * logged_scale + logged_bias))};
+    }
+    return make(aType, std::log2(static_cast<double>(aValue) / 10.0));
+
+} // hidb::bin::titer_t::from_value
+
+// ----------------------------------------------------------------------
+
+hidb::bin::titer_t hidb::bin::titer_t::make(std::string_view aTiter)
+{
+      // ignore padding after titer
+    while (!aTiter.empty() && !aTiter.back())
+        aTiter.remove_suffix(1);
+    if (aTiter.empty() || aTiter == "*")
+        return titer_t{};
+
+    type_t type = regular;
+    switch (aTiter.front()) {
+        case '<':
+            type = less_than;
+            aTiter.remove_prefix(1);
+            break;
+        case '>':
+            type = more_than;
+            aTiter.remove_prefix(1);
+            break;
+        case '~':
+            type = dodgy;
+            aTiter.remove_prefix(1);
+            break;
+        default:
+            break;
+    }
+
+    if (aTiter.empty())
+        throw invalid_titer{};
+    size_t value = 0;
+    for (const char cc : aTiter) {
+        if (cc < '0' || cc > '9')
+            throw invalid_titer{};
+        value = value * 10 + static_cast<size_t>(cc - '0');
+    }
+    if (value == 0)
+        throw invalid_titer{};
+    return from_value(type, value);
+
+} // hidb::bin::titer_t::make
+
+// ----------------------------------------------------------------------
+
+hidb::bin::TableSummary hidb::bin::TableSummary::make(const titer_t* aTiters, size_t aNumberOfTiters)
+{
+    TableSummary summary{};
+    summary.total = static_cast<uint32_t>(aNumberOfTiters);
+    for (const auto* titer = aTiters; titer != aTiters + aNumberOfTiters; ++titer) {
+        switch (titer->type()) {
+            case titer_t::dont_care:
+                ++summary.dont_care;
+                continue;
+            case titer_t::less_than:
+                ++summary.less_than;
+                break;
+            case titer_t::more_than:
+                ++summary.more_than;
+                break;
+            case titer_t::regular:
+            case titer_t::dodgy:
+                ++summary.levels[static_cast<size_t>(std::clamp(std::lround(titer->logged()), 0L, static_cast<long>(number_of_levels - 1)))];
+                break;
+        }
+        if (summary.max.is_dont_care() || titer->logged_with_thresholded() > summary.max.logged_with_thresholded())
+            summary.max = *titer;
+    }
+    return summary;
+
+} // hidb::bin::TableSummary::make
+
+// ----------------------------------------------------------------------
+
+std::string hidb::bin::Serum::name(const Strings& aStrings) const
 {
       // host, location, year are empty if name was not recognized
-    return acmacs::string::join(acmacs::string::join_slash, host(), location(), isolation(), std::string_view(year()));
+    return acmacs::string::join(acmacs::string::join_slash, host(aStrings), location(aStrings), isolation(), std::string_view(year()));
 
 } // hidb::bin::Serum::name
 
 // ----------------------------------------------------------------------
 
+std::string hidb::bin::Serum::full_name(const Strings& aStrings) const
+{
+    return acmacs::string::join(acmacs::string::join_space, name(aStrings), acmacs::string::join(acmacs::string::join_space, annotations()), reassortant(), serum_id());
+
+} // hidb::bin::Serum::full_name
+
+// ----------------------------------------------------------------------
+
 #ifndef __clang__
 #pragma GCC push_options
 // g++ optimization bug (O2 leads to seg fault)
@@ -141,14 +644,28 @@ std::string hidb::bin::Serum::name() const
 std::vector<std::string_view> hidb::bin::Serum::annotations() const
 {
     std::vector<std::string_view> result;
-    for (size_t no = 0; no < sizeof(annotation_offset); ++no) {
-        if (const auto size = annotation_offset[no+1] - annotation_offset[no]; size > 0)
+    for (size_t no = 0; no < std::size(annotation_offset); ++no) {
+        if (const auto size = annotation_end(no) - annotation_offset[no]; size > 0)
             result.emplace_back(_start() + annotation_offset[no], static_cast<size_t>(size));
     }
     return result;
 
 } // hidb::bin::Serum::annotations
 
+// ----------------------------------------------------------------------
+
+bool hidb::bin::Serum::has_full_name(std::string_view aFullName, const Strings& aStrings) const
+{
+    joined_matcher match{aFullName};
+    match(host(aStrings), '/')(location(aStrings), '/')(isolation(), '/')({year_data, *year_data ? sizeof(year_data) : 0}, '/'); // name is the first piece, no separator before it
+    for (size_t no = 0; no < std::size(annotation_offset); ++no) {
+        if (const auto size = annotation_end(no) - annotation_offset[no]; size > 0)
+            match({_start() + annotation_offset[no], static_cast<size_t>(size)}, ' ');
+    }
+    return match(reassortant(), ' ')(serum_id(), ' ').matched();
+
+} // hidb::bin::Serum::has_full_name
+
 #ifndef __clang__
 #pragma GCC pop_options
 #endif
@@ -2,8 +2,12 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
+#include <algorithm>
+#include <iterator>
 #include <stdexcept>
 #include <cinttypes>
+#include <cmath>
 
 // ----------------------------------------------------------------------
 
@@ -18,8 +22,11 @@ namespace hidb::bin
     using homologous_t = uint32_t;
     using antigen_index_t = uint32_t;
     using serum_index_t = uint32_t;
+    using section_id_t = uint32_t;
+    using string_id_t = uint32_t;
 
     class invalid_date : public std::exception {};
+    class invalid_titer : public std::exception {};
 
     struct Header
     {
@@ -42,9 +49,82 @@ namespace hidb::bin
 
       // ----------------------------------------------------------------------
 
+      // STRS section: number of strings, (number-of-strings + 1) offsets, characters
+      // strings are unique and sorted, id 0 is the empty string, i.e. ids compare in the same order as strings
+      // host, location, passage, serum species, assay, lab and rbc of the records are ids in it since format version 2,
+      // accessors of these fields take Strings of HiDb (see HiDb::strings()), empty Strings means the fields are stored in the records (hidb5b made before)
+    class Strings
+    {
+     public:
+        Strings() = default;
+        Strings(std::string_view aSection)
+        {
+            if (!aSection.empty()) {
+                number_of_ = *reinterpret_cast<const uint32_t*>(aSection.data());
+                offsets_ = reinterpret_cast<const uint32_t*>(aSection.data() + sizeof(uint32_t));
+                first_ = aSection.data() + sizeof(uint32_t) * (number_of_ + 2);
+            }
+        }
+
+        size_t size() const { return number_of_; }
+        bool empty() const { return number_of_ == 0; }
+        std::string_view operator[](string_id_t aId) const { return {first_ + offsets_[aId], static_cast<size_t>(offsets_[aId + 1] - offsets_[aId])}; }
+
+          // size() if not found
+        string_id_t find(std::string_view aText) const
+            {
+                string_id_t first = 0, last = static_cast<string_id_t>(number_of_);
+                while (first < last) {
+                    const auto middle = first + (last - first) / 2;
+                    if (operator[](middle) < aText)
+                        first = middle + 1;
+                    else
+                        last = middle;
+                }
+                return (first < number_of_ && operator[](first) == aText) ? first : static_cast<string_id_t>(number_of_);
+            }
+
+     private:
+        size_t number_of_ = 0;
+        const uint32_t* offsets_ = nullptr;
+        const char* first_ = nullptr;
+
+    }; // class Strings
+
+      // ids of the repeated fields stored at the beginning of the data of each antigen, serum, table record (format version 2 and later)
+    struct AntigenStringIds
+    {
+        string_id_t host;
+        string_id_t location;
+        string_id_t passage;
+    };
+
+    struct SerumStringIds
+    {
+        string_id_t host;
+        string_id_t location;
+        string_id_t passage;
+        string_id_t serum_species;
+    };
+
+    struct TableStringIds
+    {
+        string_id_t assay;
+        string_id_t lab;
+        string_id_t rbc;
+    };
+
+    static_assert(sizeof(AntigenStringIds) == 12);
+    static_assert(sizeof(SerumStringIds) == 16);
+    static_assert(sizeof(TableStringIds) == 12);
+
+      // ----------------------------------------------------------------------
+
+      // format version 2 and later: AntigenStringIds, isolation, ... (location_offset == isolation_offset, passage_offset == reassortant_offset)
+      // before that: host, location, isolation, passage, ...
     struct Antigen
     {
-        uint8_t location_offset; // from the beginning of host (end of year)
+        uint8_t location_offset; // from the beginning of the data after the record (end of year)
         uint8_t isolation_offset;
         uint8_t passage_offset;
         uint8_t reassortant_offset;
@@ -59,19 +139,25 @@ namespace hidb::bin
 
         char year_data[4];
 
-        std::string name() const;
+        std::string name(const Strings& aStrings) const;
         std::string date(bool compact) const;
         date_t date_raw() const;
-        std::string_view host() const { return {_start(), static_cast<size_t>(location_offset)}; }
-        std::string_view location() const { return {_start() + location_offset, static_cast<size_t>(isolation_offset - location_offset)}; }
+        const AntigenStringIds& string_ids() const { return *reinterpret_cast<const AntigenStringIds*>(_start()); } // format version 2 and later
+        std::string_view host(const Strings& aStrings) const { return aStrings.empty() ? std::string_view{_start(), static_cast<size_t>(location_offset)} : aStrings[string_ids().host]; }
+        std::string_view location(const Strings& aStrings) const { return aStrings.empty() ? std::string_view{_start() + location_offset, static_cast<size_t>(isolation_offset - location_offset)} : aStrings[string_ids().location]; }
         std::string_view isolation() const { return {_start() + isolation_offset, static_cast<size_t>(passage_offset - isolation_offset)}; }
         std::string year() const { if (*year_data) return std::string(year_data, sizeof(year_data)); else return std::string{}; }
         std::string_view year_fast() const { return {year_data, sizeof(year_data)}; } // call cdc_name() first!
-        std::string_view passage() const { return {_start() + passage_offset, static_cast<size_t>(reassortant_offset - passage_offset)}; }
+        std::string_view passage(const Strings& aStrings) const { return aStrings.empty() ? std::string_view{_start() + passage_offset, static_cast<size_t>(reassortant_offset - passage_offset)} : aStrings[string_ids().passage]; }
         std::string_view reassortant() const { return {_start() + reassortant_offset, static_cast<size_t>(annotation_offset[0] - reassortant_offset)}; }
         bool cdc_name() const { return *year_data == 0; }
         std::vector<std::string_view> lab_ids() const;
+        bool has_lab_id(std::string_view aLabId) const; // does not allocate
         std::vector<std::string_view> annotations() const;
+        uint8_t annotation_end(size_t aNo) const { return aNo + 1 < std::size(annotation_offset) ? annotation_offset[aNo + 1] : lab_id_offset[0]; } // the last annotation ends where lab ids start
+        uint8_t lab_id_end(size_t aNo) const { return aNo + 1 < std::size(lab_id_offset) ? lab_id_offset[aNo + 1] : date_offset; } // the last lab id ends where date starts
+        std::string full_name(const Strings& aStrings) const; // name, annotations, reassortant, passage; without virus type, key of the ANFN section
+        bool has_full_name(std::string_view aFullName, const Strings& aStrings) const; // full_name() == aFullName, does not allocate
 
         inline std::pair<number_of_table_indexes_t, const table_index_t*> tables() const
             {
@@ -90,9 +176,11 @@ namespace hidb::bin
 
       // ----------------------------------------------------------------------
 
+      // format version 2 and later: SerumStringIds, isolation, ..., serum id, padding, ... (location_offset == isolation_offset, passage_offset == reassortant_offset)
+      // before that: host, location, isolation, passage, ..., serum id, serum species, padding, ...
     struct Serum
     {
-        uint8_t location_offset; // from the beginning of host (end of year)
+        uint8_t location_offset; // from the beginning of the data after the record (end of year)
         uint8_t isolation_offset;
         uint8_t passage_offset;
         uint8_t reassortant_offset;
@@ -107,24 +195,30 @@ namespace hidb::bin
 
         char year_data[4];
 
-        std::string name() const;
-        inline std::string_view host() const { return {_start(), static_cast<size_t>(location_offset)}; }
-        inline std::string_view location() const { return {_start() + location_offset, static_cast<size_t>(isolation_offset - location_offset)}; }
+        std::string name(const Strings& aStrings) const;
+        inline const SerumStringIds& string_ids() const { return *reinterpret_cast<const SerumStringIds*>(_start()); } // format version 2 and later
+        inline std::string_view host(const Strings& aStrings) const { return aStrings.empty() ? std::string_view{_start(), static_cast<size_t>(location_offset)} : aStrings[string_ids().host]; }
+        inline std::string_view location(const Strings& aStrings) const { return aStrings.empty() ? std::string_view{_start() + location_offset, static_cast<size_t>(isolation_offset - location_offset)} : aStrings[string_ids().location]; }
         inline std::string_view isolation() const { return {_start() + isolation_offset, static_cast<size_t>(passage_offset - isolation_offset)}; }
         inline std::string year() const { if (*year_data) return std::string(year_data, sizeof(year_data)); else return std::string{}; }
-        inline std::string_view passage() const { return {_start() + passage_offset, static_cast<size_t>(reassortant_offset - passage_offset)}; }
+        inline std::string_view passage(const Strings& aStrings) const { return aStrings.empty() ? std::string_view{_start() + passage_offset, static_cast<size_t>(reassortant_offset - passage_offset)} : aStrings[string_ids().passage]; }
         inline std::string_view reassortant() const { return {_start() + reassortant_offset, static_cast<size_t>(annotation_offset[0] - reassortant_offset)}; }
         std::vector<std::string_view> annotations() const;
+        uint8_t annotation_end(size_t aNo) const { return aNo + 1 < std::size(annotation_offset) ? annotation_offset[aNo + 1] : serum_id_offset; } // the last annotation ends where serum id starts
         inline std::string_view serum_id() const { return {_start() + serum_id_offset, static_cast<size_t>(serum_species_offset - serum_id_offset)}; }
+        std::string full_name(const Strings& aStrings) const; // name, annotations, reassortant, serum id; without virus type, key of the SRFN section
+        bool has_full_name(std::string_view aFullName, const Strings& aStrings) const; // full_name() == aFullName, does not allocate
 
-        inline std::string serum_species() const
+        inline std::string_view serum_species(const Strings& aStrings) const
             {
+                if (!aStrings.empty())
+                    return aStrings[string_ids().serum_species];
                   // ignore padding after serum species
                 const auto* start = _start() + serum_species_offset;
                 auto* end = _start() + homologous_antigen_index_offset;
                 while (end > start && !end[-1])
                     --end;
-                return std::string(start, static_cast<size_t>(end - start));
+                return std::string_view(start, static_cast<size_t>(end - start));
             }
 
         inline std::pair<size_t, const homologous_t*> homologous_antigens() const
@@ -145,6 +239,8 @@ namespace hidb::bin
 
       // ----------------------------------------------------------------------
 
+      // format version 2 and later: TableStringIds, date, padding, ... (lab_offset == rbc_offset)
+      // before that: assay, date, lab, rbc, padding, ...
     struct Table
     {
         uint8_t date_offset;
@@ -155,12 +251,15 @@ namespace hidb::bin
         uint32_t serum_index_offset;
         uint32_t titer_offset;
 
-        inline std::string_view assay() const { return std::string_view(_start(), date_offset); }
-        inline std::string_view lab() const { return std::string_view(_start() + lab_offset, rbc_offset - lab_offset); }
+        inline const TableStringIds& string_ids() const { return *reinterpret_cast<const TableStringIds*>(_start()); } // format version 2 and later
+        inline std::string_view assay(const Strings& aStrings) const { return aStrings.empty() ? std::string_view(_start(), date_offset) : aStrings[string_ids().assay]; }
+        inline std::string_view lab(const Strings& aStrings) const { return aStrings.empty() ? std::string_view(_start() + lab_offset, rbc_offset - lab_offset) : aStrings[string_ids().lab]; }
         inline std::string_view date() const { return std::string_view(_start() + date_offset, lab_offset - date_offset); }
 
-        inline std::string_view rbc() const
+        inline std::string_view rbc(const Strings& aStrings) const
             {
+                if (!aStrings.empty())
+                    return aStrings[string_ids().rbc];
                   // ignore padding after rbc species
                 const auto* start = _start() + rbc_offset;
                 auto* end = _start() + antigen_index_offset;
@@ -177,6 +276,33 @@ namespace hidb::bin
         inline const antigen_index_t* serum_begin() const { return reinterpret_cast<const antigen_index_t*>(_start() + serum_index_offset); }
         inline const antigen_index_t* serum_end() const { return reinterpret_cast<const antigen_index_t*>(_start() + titer_offset); }
 
+          // position of antigen (serum) in antigen_begin()..antigen_end() (serum_begin()..serum_end()), number_of_antigens() (number_of_sera()) if not in the table
+        inline size_t antigen_no(antigen_index_t aIndex) const
+            {
+                const auto* found = std::lower_bound(antigen_begin(), antigen_end(), aIndex);
+                return (found != antigen_end() && *found == aIndex) ? static_cast<size_t>(found - antigen_begin()) : number_of_antigens();
+            }
+        inline size_t serum_no(serum_index_t aIndex) const
+            {
+                const auto* found = std::lower_bound(serum_begin(), serum_end(), aIndex);
+                return (found != serum_end() && *found == aIndex) ? static_cast<size_t>(found - serum_begin()) : number_of_sera();
+            }
+
+        inline size_t max_titer_length() const { return static_cast<size_t>(static_cast<uint8_t>(_start()[titer_offset])); }
+        inline const char* titer_begin() const { return _start() + titer_offset + 1; }
+
+          // aAntigenNo, aSerumNo - positions in antigen_begin()..antigen_end() and serum_begin()..serum_end()
+        inline std::string_view titer(size_t aAntigenNo, size_t aSerumNo) const
+            {
+                  // ignore padding after titer
+                const auto length = max_titer_length();
+                const auto* start = titer_begin() + (aAntigenNo * number_of_sera() + aSerumNo) * length;
+                auto* end = start + length;
+                while (end > start && !end[-1])
+                    --end;
+                return std::string_view(start, static_cast<size_t>(end - start));
+            }
+
      private:
         inline const char* _start() const { return reinterpret_cast<const char*>(this) + sizeof(*this); }
 
@@ -184,8 +310,504 @@ namespace hidb::bin
 
       // ----------------------------------------------------------------------
 
+      // antigens, sera or tables part of the hidb5b data: number of records, offsets of records, records
+    template <typename Rec> class Part
+    {
+     public:
+        Part(const char* aData, uint32_t aPartOffset)
+            : number_of_{*reinterpret_cast<const ast_number_t*>(aData + aPartOffset)},
+              index_{reinterpret_cast<const ast_offset_t*>(aData + aPartOffset + sizeof(ast_number_t))},
+              first_{aData + aPartOffset + sizeof(ast_number_t) + sizeof(ast_offset_t) * (number_of_ + 1)}
+        {
+        }
+
+        size_t size() const { return number_of_; }
+        const Rec& operator[](size_t aNo) const { return *reinterpret_cast<const Rec*>(first_ + index_[aNo]); }
+        const ast_offset_t* index() const { return index_; }
+        const char* first() const { return first_; }
+
+     private:
+        size_t number_of_;
+        const ast_offset_t* index_;
+        const char* first_;
+
+    }; // class Part<Rec>
+
+      // non-owning view of a contiguous array in the hidb5b data
+    template <typename T> class span
+    {
+     public:
+        constexpr span() = default;
+        constexpr span(const T* aFirst, size_t aSize) : first_{aFirst}, size_{aSize} {}
+
+        constexpr size_t size() const { return size_; }
+        constexpr bool empty() const { return size_ == 0; }
+        constexpr const T* data() const { return first_; }
+        constexpr const T* begin() const { return first_; }
+        constexpr const T* end() const { return first_ + size_; }
+        constexpr const T& operator[](size_t aNo) const { return first_[aNo]; }
+        constexpr const T& front() const { return first_[0]; }
+        constexpr const T& back() const { return first_[size_ - 1]; }
+
+     private:
+        const T* first_ = nullptr;
+        size_t size_ = 0;
+
+    }; // class span<T>
+
+      // ----------------------------------------------------------------------
+
+    struct titer_t
+    {
+        enum type_t : uint16_t { dont_care = 0, regular = 1, less_than = 2, more_than = 3, dodgy = 4 };
+
+        constexpr static const uint16_t type_shift = 13;
+        constexpr static const uint16_t logged_mask = (1 << type_shift) - 1;
+        constexpr static const int logged_scale = 64;  // logged titer is stored in 1/64 of log2 step
+        constexpr static const int logged_bias = 1024; // titer 10 (logged 0)
+
+        uint16_t data = 0;
+
+        constexpr type_t type() const { return static_cast<type_t>(data >> type_shift); }
+        constexpr bool is_dont_care() const { return type() == dont_care; }
+        constexpr bool is_regular() const { return type() == regular; }
+        constexpr bool is_less_than() const { return type() == less_than; }
+        constexpr bool is_more_than() const { return type() == more_than; }
+        constexpr bool is_dodgy() const { return type() == dodgy; }
+
+        constexpr int logged_raw() const { return static_cast<int>(data & logged_mask) - logged_bias; } // log2(titer/10) * logged_scale
+        constexpr double logged() const { return static_cast<double>(logged_raw()) / logged_scale; }
+        double logged_with_thresholded() const
+            {
+                switch (type()) {
+                    case less_than:
+                        return logged() - 1.0;
+                    case more_than:
+                        return logged() + 1.0;
+                    case dont_care:
+                    case regular:
+                    case dodgy:
+                        break;
+                }
+                return logged();
+            }
+        size_t value() const { return is_dont_care() ? 0 : static_cast<size_t>(std::lround(10.0 * std::exp2(logged()))); }
+
+        constexpr bool operator==(titer_t rhs) const { return data == rhs.data; }
+        constexpr bool operator!=(titer_t rhs) const { return data != rhs.data; }
+
+        static titer_t make(type_t aType, double aLogged);
+        static titer_t from_value(type_t aType, size_t aValue); // aValue > 0
+        static titer_t make(std::string_view aTiter); // text titer (zero padding allowed): *, 40, <10, >1280, ~80; throws invalid_titer
+
+    }; // struct titer_t
+
+    static_assert(sizeof(titer_t) == 2);
+
+      // ----------------------------------------------------------------------
+
+    struct TableSummary
+    {
+        constexpr static const size_t number_of_levels = 16;
+
+        uint32_t levels[number_of_levels]; // number of regular and dodgy titers by log2 level: 0 - 10 and below, 1 - 20, 2 - 40, ..., 15 - 327680 and above
+        uint32_t less_than;                // number of <titers
+        uint32_t more_than;                // number of >titers
+        uint32_t dont_care;                // number of *
+        uint32_t total;                    // number of antigens * number of sera
+        titer_t max;                       // dont-care if all titers are dont-care, >1280 is more than 1280
+        uint16_t _padding1;
+        uint32_t _padding2;
+
+        double missing_fraction() const { return total ? static_cast<double>(dont_care) / static_cast<double>(total) : 0.0; }
+
+        static TableSummary make(const titer_t* aTiters, size_t aNumberOfTiters);
+    };
+
+    static_assert(sizeof(TableSummary) == 88);
+
+      // ----------------------------------------------------------------------
+
+      // TBND section: numeric date of each table in the order of tables part
+    struct TableDate
+    {
+        date_t date;       // 20160602, 0 if table date is not recognized
+        uint32_t sequence; // 2 for 20160602.002, 0 if date has no sequence number
+
+        constexpr bool operator==(TableDate rhs) const { return date == rhs.date && sequence == rhs.sequence; }
+        constexpr bool operator!=(TableDate rhs) const { return !operator==(rhs); }
+        constexpr bool operator<(TableDate rhs) const { return date == rhs.date ? sequence < rhs.sequence : date < rhs.date; }
+        constexpr bool operator>(TableDate rhs) const { return rhs < *this; }
+
+        static TableDate make(std::string_view aDate); // 20160602.002, does not throw
+    };
+
+      // ANDT section: antigens sorted by Antigen::date_raw(), then by antigen index
+    struct DatedAntigen
+    {
+        date_t date;
+        antigen_index_t antigen;
+    };
+
+      // TBDT section: tables sorted by numeric date, then by table index
+    struct DatedTable
+    {
+        TableDate date;
+        table_index_t table;
+    };
+
+    static_assert(sizeof(TableDate) == 8);
+    static_assert(sizeof(DatedAntigen) == 8);
+    static_assert(sizeof(DatedTable) == 12);
+
+      // ----------------------------------------------------------------------
+
+      // ANKY, SRKY sections: name key of each antigen (serum) in the order of the Part (i.e. sorted by location, isolation, year)
+      // location and isolation prefixes are zero padded, a prefix not ending with zero may be truncated, year is empty for cdc names
+    struct NameKey
+    {
+        constexpr static const size_t location_size = 16;
+        constexpr static const size_t isolation_size = 12;
+        constexpr static const size_t year_size = 4;
+
+        char location[location_size];
+        char isolation[isolation_size];
+        char year[year_size];
+    };
+
+    static_assert(sizeof(NameKey) == 32);
+
+      // ALID (antigen lab ids), SRID (serum ids), ANFN, SRFN (antigen and serum full names) sections:
+      // open addressing hash index (linear probing) of record indexes in the order of the Part, keys are not stored,
+      // found records must be checked against the key
+    constexpr uint64_t hash(std::string_view aKey) // FNV-1a, persisted in the sections, must not change
+    {
+        uint64_t result = 0xcbf29ce484222325ULL;
+        for (const char cc : aKey)
+            result = (result ^ static_cast<uint8_t>(cc)) * 0x100000001b3ULL;
+        return result;
+    }
+
+    struct HashSlot
+    {
+        uint32_t tag;   // upper 32 bits of hash
+        uint32_t value; // record index + 1, 0 - empty slot
+    };
+
+    static_assert(sizeof(HashSlot) == 8);
+
+    class HashIndex
+    {
+     public:
+        HashIndex(std::string_view aSection)
+            : number_of_slots_{aSection.empty() ? 0 : *reinterpret_cast<const uint32_t*>(aSection.data())},
+              slots_{aSection.empty() ? nullptr : reinterpret_cast<const HashSlot*>(aSection.data() + sizeof(uint32_t) * 2)} {}
+
+        bool empty() const { return number_of_slots_ == 0; }
+
+          // calls aFound(record index) for each record whose key hash matches, until aFound returns true
+        template <typename F> void find(std::string_view aKey, F&& aFound) const
+            {
+                const auto hsh = hash(aKey);
+                const auto tag = static_cast<uint32_t>(hsh >> 32);
+                const auto mask = number_of_slots_ - 1; // number of slots is power of 2
+                for (auto slot = static_cast<size_t>(hsh) & mask; slots_[slot].value != 0; slot = (slot + 1) & mask) {
+                    if (slots_[slot].tag == tag && aFound(static_cast<size_t>(slots_[slot].value - 1)))
+                        return;
+                }
+            }
+
+     private:
+        size_t number_of_slots_;
+        const HashSlot* slots_;
+
+    }; // class HashIndex
+
+      // ANLT, SRLT sections: search tree over unique location prefixes of antigens (sera) in Eytzinger layout, node 0 is header
+      // node k has children 2k and 2k+1, two nodes per cache line, lookup is branchless descent with prefetching
+    struct LocationNode
+    {
+        constexpr static const size_t location_size = 24;
+
+        char location[location_size]; // zero padded, truncated if it does not end with 0
+        uint32_t first;                // range of antigens (sera) in the order of the Part having this location prefix
+        uint32_t last;
+    };
+
+    static_assert(sizeof(LocationNode) == 32);
+
+    class LocationTree
+    {
+     public:
+        LocationTree(std::string_view aSection)
+            : nodes_{aSection.empty() ? nullptr : reinterpret_cast<const LocationNode*>(aSection.data())}, number_of_{aSection.empty() ? 0 : nodes_[0].first} {}
+
+        bool empty() const { return number_of_ == 0; }
+
+          // range of antigens (sera) whose location starts with the same prefix as aLocation (i.e. candidates to be checked further), {0, 0} if none
+        std::pair<size_t, size_t> find(std::string_view aLocation) const;
+
+     private:
+        const LocationNode* nodes_;
+        size_t number_of_;
+
+    }; // class LocationTree
+
+      // ANTG, SRTG sections: trigram inverted index over similarity keys of antigens (sera), see similarity_key()
+      // number of trigrams, sorted trigrams, (number-of-trigrams + 1) offsets (in record indexes), sorted indexes of the records having each trigram
+    using trigram_t = uint32_t;
+
+      // LOCATION/ISOLATION/YEAR, year is empty for cdc names
+    inline std::string similarity_key(std::string_view aLocation, std::string_view aIsolation, std::string_view aYear)
+    {
+        std::string key(aLocation);
+        key.append(1, '/').append(aIsolation).append(1, '/').append(aYear);
+        return key;
+    }
+
+      // calls aF(trigram) for each trigram of aKey padded with a space at both ends, the same trigram may be reported more than once
+    template <typename F> inline void for_each_trigram(std::string_view aKey, F&& aF)
+    {
+        const auto at = [aKey](size_t pos) -> trigram_t { return (pos == 0 || pos > aKey.size()) ? trigram_t{' '} : static_cast<uint8_t>(aKey[pos - 1]); };
+        for (size_t pos = 0; pos < aKey.size(); ++pos)
+            aF((at(pos) << 16) | (at(pos + 1) << 8) | at(pos + 2));
+    }
+
+    class TrigramIndex
+    {
+     public:
+        TrigramIndex(std::string_view aSection)
+        {
+            if (!aSection.empty()) {
+                number_of_ = *reinterpret_cast<const uint32_t*>(aSection.data());
+                trigrams_ = reinterpret_cast<const trigram_t*>(aSection.data()) + 1;
+                offsets_ = trigrams_ + number_of_;
+                records_ = offsets_ + number_of_ + 1;
+            }
+        }
+
+        bool empty() const { return number_of_ == 0; }
+
+          // sorted indexes of antigens (sera) having aTrigram in their similarity keys, empty range if none
+        std::pair<const uint32_t*, const uint32_t*> find(trigram_t aTrigram) const
+            {
+                if (number_of_ == 0)
+                    return {nullptr, nullptr};
+                const auto* found = std::lower_bound(trigrams_, trigrams_ + number_of_, aTrigram);
+                if (found == trigrams_ + number_of_ || *found != aTrigram)
+                    return {records_, records_};
+                const auto no = static_cast<size_t>(found - trigrams_);
+                return {records_ + offsets_[no], records_ + offsets_[no + 1]};
+            }
+
+     private:
+        size_t number_of_ = 0;
+        const trigram_t* trigrams_ = nullptr;
+        const uint32_t* offsets_ = nullptr;
+        const uint32_t* records_ = nullptr;
+
+    }; // class TrigramIndex
+
+      // ANCP, SRCP sections: distinct names (see Antigen::name(), Serum::name()) of antigens (sera) for prefix completion, sorted
+      // each name has the number of tables of all antigens (sera) with this name and the first of them,
+      // prefixes shared by more than scan_limit names have their top_size completions (most tables first) precomputed
+    class Completions
+    {
+     public:
+        constexpr static const size_t top_size = 16;
+        constexpr static const size_t scan_limit = 64;
+
+        struct Prefix
+        {
+            uint32_t first;  // first completion (in name order) starting with the prefix
+            uint32_t length; // prefix is the first length chars of the name of the first completion
+            uint32_t top[top_size];
+        };
+
+        Completions(std::string_view aSection)
+        {
+            if (!aSection.empty()) {
+                const auto* header = reinterpret_cast<const uint32_t*>(aSection.data());
+                number_of_ = header[0];
+                number_of_prefixes_ = header[1];
+                offsets_ = header + 2;
+                number_of_tables_ = offsets_ + number_of_ + 1;
+                first_ = number_of_tables_ + number_of_;
+                prefixes_ = reinterpret_cast<const Prefix*>(first_ + number_of_);
+                characters_ = reinterpret_cast<const char*>(prefixes_ + number_of_prefixes_);
+            }
+        }
+
+        bool empty() const { return number_of_ == 0; }
+        size_t size() const { return number_of_; }
+        std::string_view name(size_t aNo) const { return {characters_ + offsets_[aNo], static_cast<size_t>(offsets_[aNo + 1] - offsets_[aNo])}; }
+        size_t number_of_tables(size_t aNo) const { return number_of_tables_[aNo]; }
+        size_t first(size_t aNo) const { return first_[aNo]; } // antigen (serum) index
+
+          // at most aNumber (at most top_size) completions whose names start with aPrefix, most tables first, then in name order
+        std::vector<size_t> top(std::string_view aPrefix, size_t aNumber) const;
+
+     private:
+        size_t number_of_ = 0;
+        size_t number_of_prefixes_ = 0;
+        const uint32_t* offsets_ = nullptr;
+        const uint32_t* number_of_tables_ = nullptr;
+        const uint32_t* first_ = nullptr;
+        const Prefix* prefixes_ = nullptr;
+        const char* characters_ = nullptr;
+
+    }; // class Completions
+
+    static_assert(sizeof(Completions::Prefix) == 72);
+
+      // ----------------------------------------------------------------------
+
+      // optional sections after the tables part, see doc/hidb5-bin-format.txt
+
+    constexpr section_id_t make_section_id(const char (&aId)[5])
+    {
+        return static_cast<section_id_t>(static_cast<uint8_t>(aId[0])) | (static_cast<section_id_t>(static_cast<uint8_t>(aId[1])) << 8)
+            | (static_cast<section_id_t>(static_cast<uint8_t>(aId[2])) << 16) | (static_cast<section_id_t>(static_cast<uint8_t>(aId[3])) << 24);
+    }
+
+    namespace section
+    {
+        constexpr const section_id_t titers = make_section_id("TITR");
+        constexpr const section_id_t table_summaries = make_section_id("TSUM");
+        constexpr const section_id_t strings = make_section_id("STRS");
+        constexpr const section_id_t antigen_name_keys = make_section_id("ANKY");
+        constexpr const section_id_t serum_name_keys = make_section_id("SRKY");
+        constexpr const section_id_t antigen_location_tree = make_section_id("ANLT");
+        constexpr const section_id_t serum_location_tree = make_section_id("SRLT");
+        constexpr const section_id_t antigen_lab_ids = make_section_id("ALID");
+        constexpr const section_id_t serum_ids = make_section_id("SRID");
+        constexpr const section_id_t antigen_full_names = make_section_id("ANFN");
+        constexpr const section_id_t serum_full_names = make_section_id("SRFN");
+        constexpr const section_id_t table_dates = make_section_id("TBND");
+        constexpr const section_id_t antigens_by_date = make_section_id("ANDT");
+        constexpr const section_id_t tables_by_date = make_section_id("TBDT");
+        constexpr const section_id_t homologous_sera = make_section_id("AGHS");
+        constexpr const section_id_t reference_antigens = make_section_id("TBRA");
+        constexpr const section_id_t table_groups = make_section_id("TBGR");
+        constexpr const section_id_t antigen_trigrams = make_section_id("ANTG");
+        constexpr const section_id_t serum_trigrams = make_section_id("SRTG");
+        constexpr const section_id_t antigen_completions = make_section_id("ANCP");
+        constexpr const section_id_t serum_completions = make_section_id("SRCP");
+        constexpr const section_id_t format_version = make_section_id("VERS");
+
+    } // namespace section
+
+      // VERS section: version of the meaning of the records, 0 if section is absent (hidb5b made before it was introduced)
+    struct FormatVersion
+    {
+        uint32_t version;
+        uint32_t flags; // since format version 2, 0 before that
+    };
+
+    static_assert(sizeof(FormatVersion) == 8);
+
+      // titers of each table are in the order of its antigen and serum indexes, before that they were in the order of the source chart
+      // and cannot be addressed by table antigen and serum positions
+    constexpr const uint32_t format_version_titers_in_index_order = 1;
+      // host, location, passage, serum species, assay, lab and rbc are not stored in the records, records have ids of them in the STRS section
+    constexpr const uint32_t format_version_string_ids = 2;
+    constexpr const uint32_t current_format_version = format_version_string_ids;
+
+      // format version 2 and later: titers are in the order of the source chart (hidb5.json made before titer order was recorded), see format_version_titers_in_index_order
+    constexpr const uint32_t format_flag_titers_in_chart_order = 1;
+
+      // TITR section: (number-of-tables + 1) offsets (in titers) of the titers of each table, then numeric titers of all tables
+    inline const titer_t* titers_of_table(std::string_view aSection, size_t aNumberOfTables, size_t aTableNo)
+    {
+        const auto* offsets = reinterpret_cast<const uint32_t*>(aSection.data());
+        return reinterpret_cast<const titer_t*>(aSection.data() + sizeof(uint32_t) * (aNumberOfTables + 1)) + offsets[aTableNo];
+    }
+
+      // AGHS section: (number-of-antigens + 1) offsets (in serum indexes) of the sera having antigen as homologous, then sorted serum indexes of all antigens
+    inline std::pair<size_t, const serum_index_t*> homologous_sera(std::string_view aSection, size_t aNumberOfAntigens, size_t aAntigenNo)
+    {
+        const auto* offsets = reinterpret_cast<const uint32_t*>(aSection.data());
+        return {offsets[aAntigenNo + 1] - offsets[aAntigenNo], reinterpret_cast<const serum_index_t*>(offsets + aNumberOfAntigens + 1) + offsets[aAntigenNo]};
+    }
+
+      // TBRA section: (number-of-tables + 1) offsets (in antigen indexes) of reference antigens of each table, then sorted antigen indexes of all tables
+    inline std::pair<size_t, const antigen_index_t*> reference_antigens(std::string_view aSection, size_t aNumberOfTables, size_t aTableNo)
+    {
+        const auto* offsets = reinterpret_cast<const uint32_t*>(aSection.data());
+        return {offsets[aTableNo + 1] - offsets[aTableNo], reinterpret_cast<const antigen_index_t*>(offsets + aNumberOfTables + 1) + offsets[aTableNo]};
+    }
+
+      // TBGR section: number of groups, the first table of each group, group of each table (in the order of tables part)
+      // group is a combination of lab, assay and rbc, groups are numbered in the order of "lab:assay:rbc"
+    class TableGroups
+    {
+     public:
+        TableGroups(std::string_view aSection)
+            : number_of_{*reinterpret_cast<const uint32_t*>(aSection.data())}, first_table_{reinterpret_cast<const table_index_t*>(aSection.data()) + 1}, group_of_{first_table_ + number_of_} {}
+
+        size_t size() const { return number_of_; }
+        table_index_t first_table(size_t aGroup) const { return first_table_[aGroup]; } // to get lab, assay, rbc of the group
+        uint32_t of(size_t aTableNo) const { return group_of_[aTableNo]; }
+
+     private:
+        size_t number_of_;
+        const table_index_t* first_table_;
+        const uint32_t* group_of_;
+
+    }; // class TableGroups
+
+    struct SectionEntry
+    {
+        section_id_t id;
+        uint32_t offset; // from the beginning of signature of the whole data
+        uint32_t size;
+    };
+
+    struct SectionsHeader
+    {
+        char signature[8];
+        uint32_t number_of;
+        uint32_t _padding1;
+
+        inline const SectionEntry* begin() const { return reinterpret_cast<const SectionEntry*>(reinterpret_cast<const char*>(this) + sizeof(*this)); }
+        inline const SectionEntry* end() const { return begin() + number_of; }
+    };
+
+      // ----------------------------------------------------------------------
+
     std::string signature();
     bool has_signature(const char* data);
+    std::string sections_signature();
+    const SectionsHeader* sections(const char* data, size_t data_size); // nullptr if file has no optional sections (made before sections were introduced)
+    size_t sections_offset(const char* data); // where optional sections start (or would start)
+
+      // identifies the antigens, sera and tables of a hidb5b (optional sections are not taken into account),
+      // stored in files derived from hidb5b (hidb5csr, hidb5hom) to detect that they were made from another hidb5b
+    struct Fingerprint
+    {
+        uint64_t size; // of the header, antigens, sera and tables
+        uint64_t hash; // FNV-1a of the header and the antigen, serum and table offsets
+
+        bool operator==(const Fingerprint& rhs) const { return size == rhs.size && hash == rhs.hash; }
+        bool operator!=(const Fingerprint& rhs) const { return !operator==(rhs); }
+    };
+
+    static_assert(sizeof(Fingerprint) == 16);
+
+    Fingerprint fingerprint(const char* data);
+
+      // aStrings - see Strings, empty for hidb5b with strings stored in the records
+    std::vector<antigen_index_t> reference_antigens(const char* data, const Table& aTable, const Strings& aStrings); // computed from names, sorted, see hidb::Table::reference_antigens()
+    std::string reference_antigens_section(const char* data, const Strings& aStrings); // TBRA section data for all tables
+    std::string table_groups_section(const char* data, const Strings& aStrings); // TBGR section data
+    std::string antigen_trigrams_section(const char* data, const Strings& aStrings); // ANTG section data
+    std::string serum_trigrams_section(const char* data, const Strings& aStrings); // SRTG section data
+    std::string antigen_completions_section(const char* data, const Strings& aStrings); // ANCP section data
+    std::string serum_completions_section(const char* data, const Strings& aStrings); // SRCP section data
+
+    inline Part<Antigen> antigens(const char* data) { return {data, reinterpret_cast<const Header*>(data)->antigen_offset}; }
+    inline Part<Serum> sera(const char* data) { return {data, reinterpret_cast<const Header*>(data)->serum_offset}; }
+    inline Part<Table> tables(const char* data) { return {data, reinterpret_cast<const Header*>(data)->table_offset}; }
 
 } // namespace hidb::bin
 
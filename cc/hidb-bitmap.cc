@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <iterator>
+
+#include "acmacs-base/fmt.hh"
+#include "hidb-5/hidb-bitmap.hh"
+
+// ----------------------------------------------------------------------
+
+void hidb::Bitmap::add(uint32_t aIndex)
+{
+    const auto key = static_cast<uint16_t>(aIndex >> 16);
+    const auto low = static_cast<uint16_t>(aIndex & 0xFFFF);
+    if (chunks_.empty() || chunks_.back().key < key) {
+        chunks_.push_back(Chunk{key});
+        chunks_.back().add(low);
+    }
+    else if (chunks_.back().key == key) {
+        chunks_.back().add(low);
+    }
+    else {
+        auto found = std::lower_bound(chunks_.begin(), chunks_.end(), key, [](const Chunk& chunk, uint16_t look_for) { return chunk.key < look_for; });
+        if (found->key != key)
+            found = chunks_.insert(found, Chunk{key});
+        found->add(low);
+    }
+
+} // hidb::Bitmap::add
+
+// ----------------------------------------------------------------------
+
+bool hidb::Bitmap::contains(uint32_t aIndex) const
+{
+    const auto key = static_cast<uint16_t>(aIndex >> 16);
+    const auto found = std::lower_bound(chunks_.begin(), chunks_.end(), key, [](const Chunk& chunk, uint16_t look_for) { return chunk.key < look_for; });
+    return found != chunks_.end() && found->key == key && found->contains(static_cast<uint16_t>(aIndex & 0xFFFF));
+
+} // hidb::Bitmap::contains
+
+// ----------------------------------------------------------------------
+
+size_t hidb::Bitmap::size() const
+{
+    size_t result = 0;
+    for (const auto& chunk : chunks_)
+        result += chunk.size;
+    return result;
+
+} // hidb::Bitmap::size
+
+// ----------------------------------------------------------------------
+
+std::vector<uint32_t> hidb::Bitmap::to_vector() const
+{
+    std::vector<uint32_t> result;
+    result.reserve(size());
+    for_each([&result](uint32_t index) { result.push_back(index); });
+    return result;
+
+} // hidb::Bitmap::to_vector
+
+// ----------------------------------------------------------------------
+
+hidb::Bitmap hidb::Bitmap::operator&(const Bitmap& aOther) const
+{
+    Bitmap result;
+    for (auto chunk1 = chunks_.begin(), chunk2 = aOther.chunks_.begin(); chunk1 != chunks_.end() && chunk2 != aOther.chunks_.end();) {
+        if (chunk1->key < chunk2->key)
+            ++chunk1;
+        else if (chunk2->key < chunk1->key)
+            ++chunk2;
+        else {
+            if (auto chunk = intersection(*chunk1, *chunk2); chunk.size > 0)
+                result.chunks_.push_back(std::move(chunk));
+            ++chunk1;
+            ++chunk2;
+        }
+    }
+    return result;
+
+} // hidb::Bitmap::operator&
+
+// ----------------------------------------------------------------------
+
+hidb::Bitmap hidb::Bitmap::operator|(const Bitmap& aOther) const
+{
+    Bitmap result;
+    auto chunk1 = chunks_.begin(), chunk2 = aOther.chunks_.begin();
+    while (chunk1 != chunks_.end() && chunk2 != aOther.chunks_.end()) {
+        if (chunk1->key < chunk2->key)
+            result.chunks_.push_back(*chunk1++);
+        else if (chunk2->key < chunk1->key)
+            result.chunks_.push_back(*chunk2++);
+        else
+            result.chunks_.push_back(union_of(*chunk1++, *chunk2++));
+    }
+    result.chunks_.insert(result.chunks_.end(), chunk1, chunks_.end());
+    result.chunks_.insert(result.chunks_.end(), chunk2, aOther.chunks_.end());
+    return result;
+
+} // hidb::Bitmap::operator|
+
+// ----------------------------------------------------------------------
+
+hidb::Bitmap::Chunk hidb::Bitmap::intersection(const Chunk& aChunk1, const Chunk& aChunk2)
+{
+    Chunk result{aChunk1.key};
+    if (aChunk1.has_bits() && aChunk2.has_bits()) {
+        result.bits.resize(Chunk::number_of_words);
+        for (size_t word = 0; word < Chunk::number_of_words; ++word) {
+            result.bits[word] = aChunk1.bits[word] & aChunk2.bits[word];
+            result.size += static_cast<size_t>(__builtin_popcountll(result.bits[word]));
+        }
+        if (result.size <= array_limit)
+            result.to_array();
+    }
+    else if (aChunk1.has_bits() || aChunk2.has_bits()) {
+        const auto& with_array = aChunk1.has_bits() ? aChunk2 : aChunk1;
+        const auto& with_bits = aChunk1.has_bits() ? aChunk1 : aChunk2;
+        std::copy_if(with_array.array.begin(), with_array.array.end(), std::back_inserter(result.array), [&with_bits](uint16_t low) { return with_bits.contains(low); });
+        result.size = result.array.size();
+    }
+    else {
+        std::set_intersection(aChunk1.array.begin(), aChunk1.array.end(), aChunk2.array.begin(), aChunk2.array.end(), std::back_inserter(result.array));
+        result.size = result.array.size();
+    }
+    return result;
+
+} // hidb::Bitmap::intersection
+
+// ----------------------------------------------------------------------
+
+hidb::Bitmap::Chunk hidb::Bitmap::union_of(const Chunk& aChunk1, const Chunk& aChunk2)
+{
+    if (aChunk1.has_bits() || aChunk2.has_bits()) {
+        Chunk result = aChunk1.has_bits() ? aChunk1 : aChunk2;
+        const auto& other = aChunk1.has_bits() ? aChunk2 : aChunk1;
+        if (other.has_bits()) {
+            result.size = 0;
+            for (size_t word = 0; word < Chunk::number_of_words; ++word) {
+                result.bits[word] |= other.bits[word];
+                result.size += static_cast<size_t>(__builtin_popcountll(result.bits[word]));
+            }
+        }
+        else {
+            for (const auto low : other.array)
+                result.add(low);
+        }
+        return result;
+    }
+    else {
+        Chunk result{aChunk1.key};
+        std::set_union(aChunk1.array.begin(), aChunk1.array.end(), aChunk2.array.begin(), aChunk2.array.end(), std::back_inserter(result.array));
+        result.size = result.array.size();
+        if (result.size > array_limit)
+            result.to_bits();
+        return result;
+    }
+
+} // hidb::Bitmap::union_of
+
+// ----------------------------------------------------------------------
+
+bool hidb::Bitmap::Chunk::contains(uint16_t aLow) const
+{
+    if (has_bits())
+        return (bits[aLow >> 6] >> (aLow & 63)) & 1;
+    else
+        return std::binary_search(array.begin(), array.end(), aLow);
+
+} // hidb::Bitmap::Chunk::contains
+
+// ----------------------------------------------------------------------
+
+void hidb::Bitmap::Chunk::add(uint16_t aLow)
+{
+    if (has_bits()) {
+        const auto mask = uint64_t{1} << (aLow & 63);
+        if ((bits[aLow >> 6] & mask) == 0) {
+            bits[aLow >> 6] |= mask;
+            ++size;
+        }
+    }
+    else {
+        if (array.empty() || array.back() < aLow)
+            array.push_back(aLow);
+        else if (const auto found = std::lower_bound(array.begin(), array.end(), aLow); *found != aLow)
+            array.insert(found, aLow);
+        else
+            return;
+        if (++size > array_limit)
+            to_bits();
+    }
+
+} // hidb::Bitmap::Chunk::add
+
+// ----------------------------------------------------------------------
+
+void hidb::Bitmap::Chunk::to_bits()
+{
+    bits.assign(number_of_words, 0);
+    for (const auto low : array)
+        bits[low >> 6] |= uint64_t{1} << (low & 63);
+    array = std::vector<uint16_t>{};
+
+} // hidb::Bitmap::Chunk::to_bits
+
+// ----------------------------------------------------------------------
+
+void hidb::Bitmap::Chunk::to_array()
+{
+    array.clear();
+    array.reserve(size);
+    for (size_t word = 0; word < number_of_words; ++word) {
+        for (auto word_bits = bits[word]; word_bits != 0; word_bits &= word_bits - 1)
+            array.push_back(static_cast<uint16_t>(word * 64 + static_cast<size_t>(__builtin_ctzll(word_bits))));
+    }
+    bits = std::vector<uint64_t>{};
+
+} // hidb::Bitmap::Chunk::to_array
+
+// ----------------------------------------------------------------------
+
+  // assay and rbc spellings differ between hidb5b files (hidb5-make stores FR and PRN, older files FOCUS REDUCTION etc.) and reports (FRA, gp, tu),
+  // bitmaps are keyed and looked up by the normalized value
+std::string hidb::BitmapIndex::normalize(attribute aAttribute, std::string_view aValue)
+{
+    switch (aAttribute) {
+        case attribute::assay:
+            if (aValue == "FOCUS REDUCTION" || aValue == "FRA" || aValue == "FR")
+                return "FR";
+            else if (aValue == "PLAQUE REDUCTION NEUTRALISATION" || aValue == "PRNT" || aValue == "PRN")
+                return "PRN";
+            break;
+        case attribute::rbc:
+            if (aValue == "gp" || aValue == "GP" || aValue == "GUINEA-PIG")
+                return "guinea-pig";
+            else if (aValue == "tu" || aValue == "TU" || aValue == "TURKEY")
+                return "turkey";
+            else if (aValue == "ch" || aValue == "CH" || aValue == "CHICKEN")
+                return "chicken";
+            else if (aValue == "HUMAN")
+                return "human";
+            break;
+        case attribute::lineage:
+            return std::string{aValue.substr(0, 1)};
+        case attribute::lab:
+        case attribute::year:
+        case attribute::host:
+            break;
+    }
+    return std::string{aValue};
+
+} // hidb::BitmapIndex::normalize
+
+// ----------------------------------------------------------------------
+
+hidb::BitmapIndex::BitmapIndex(const HiDb& aHiDb)
+    : mHiDb{aHiDb}
+{
+    const auto tables = bin::tables(aHiDb.data());
+    const auto& strings = aHiDb.strings();
+    const auto bitmaps_of_table = [&strings](attribute_bitmaps_t& aBitmaps, const bin::Table& aTable) {
+        return std::array<Bitmap*, 3>{&aBitmaps[static_cast<size_t>(attribute::lab)][std::string{aTable.lab(strings)}], &aBitmaps[static_cast<size_t>(attribute::assay)][normalize(attribute::assay, aTable.assay(strings))],
+                                      &aBitmaps[static_cast<size_t>(attribute::rbc)][normalize(attribute::rbc, aTable.rbc(strings))]};
+    };
+
+      // lab, assay, rbc bitmaps to add antigens (sera) of each table to
+      // tables of the same group (see Tables::group()) share them, lab, assay and rbc strings are looked up once per group
+    const auto hidb_tables = aHiDb.tables();
+    std::vector<std::array<Bitmap*, 3>> antigen_bitmaps_of_group(hidb_tables->number_of_groups()), serum_bitmaps_of_group(hidb_tables->number_of_groups()), table_bitmaps_of_group(hidb_tables->number_of_groups());
+    std::vector<std::array<Bitmap*, 3>> antigen_bitmaps_of_table(tables.size()), serum_bitmaps_of_table(tables.size());
+    for (size_t table_no = 0; table_no < tables.size(); ++table_no) {
+        const auto group_no = hidb_tables->group(TableIndex{table_no});
+        if (table_bitmaps_of_group[group_no][0] == nullptr) { // first table of the group
+            table_bitmaps_of_group[group_no] = bitmaps_of_table(mTables, tables[table_no]);
+            antigen_bitmaps_of_group[group_no] = bitmaps_of_table(mAntigens, tables[table_no]);
+            serum_bitmaps_of_group[group_no] = bitmaps_of_table(mSera, tables[table_no]);
+        }
+        for (auto* bitmap : table_bitmaps_of_group[group_no])
+            bitmap->add(static_cast<uint32_t>(table_no));
+        antigen_bitmaps_of_table[table_no] = antigen_bitmaps_of_group[group_no];
+        serum_bitmaps_of_table[table_no] = serum_bitmaps_of_group[group_no];
+    }
+
+      // host bitmap of each host id of the records, if hidb5b stores ids (version 2), otherwise host strings are looked up for each record
+    const auto host_bitmap = [&strings](attribute_bitmaps_t& aBitmaps, std::vector<Bitmap*>& aBitmapOfId, const auto& aRef) -> Bitmap& {
+        if (!strings.empty()) {
+            const auto host = aRef.record().string_ids().host;
+            auto*& bitmap = aBitmapOfId[host];
+            if (!bitmap)
+                bitmap = &aBitmaps[static_cast<size_t>(attribute::host)][std::string{strings[host]}];
+            return *bitmap;
+        }
+        else
+            return aBitmaps[static_cast<size_t>(attribute::host)][std::string{aRef.host()}];
+    };
+
+      // records are visited in index order, i.e. indexes are appended to the bitmaps
+    const auto add = [&strings, &host_bitmap](const auto& aRefs, const std::vector<std::array<Bitmap*, 3>>& aBitmapsOfTable, attribute_bitmaps_t& aBitmaps, std::array<Bitmap, 3>& aPassages) {
+        std::vector<Bitmap*> host_bitmap_of_id(strings.size(), nullptr);
+        for (const auto& ref : aRefs) {
+            const auto no = static_cast<uint32_t>(*ref.index());
+            for (const auto table_no : ref.tables()) {
+                for (auto* bitmap : aBitmapsOfTable[table_no])
+                    bitmap->add(no);
+            }
+            if (const auto lineage = ref.record().lineage; lineage != 0)
+                aBitmaps[static_cast<size_t>(attribute::lineage)][std::string(1, lineage)].add(no);
+            if (const auto year = ref.year(); !year.empty())
+                aBitmaps[static_cast<size_t>(attribute::year)][year].add(no);
+            host_bitmap(aBitmaps, host_bitmap_of_id, ref).add(no);
+            aPassages[static_cast<size_t>(range::passage_class_of(ref))].add(no);
+        }
+    };
+    add(aHiDb.antigen_refs(), antigen_bitmaps_of_table, mAntigens, mAntigenPassages);
+    add(aHiDb.serum_refs(), serum_bitmaps_of_table, mSera, mSerumPassages);
+
+} // hidb::BitmapIndex::BitmapIndex
+
+// ----------------------------------------------------------------------
+
+const hidb::Bitmap& hidb::BitmapIndex::find(const attribute_bitmaps_t& aBitmaps, attribute aAttribute, std::string_view aValue)
+{
+    static const Bitmap empty;
+    const auto& bitmaps = aBitmaps[static_cast<size_t>(aAttribute)];
+    if (const auto found = bitmaps.find(normalize(aAttribute, aValue)); found != bitmaps.end())
+        return found->second;
+    else
+        return empty;
+
+} // hidb::BitmapIndex::find
+
+// ----------------------------------------------------------------------
+
+hidb::Bitmap hidb::BitmapIndex::of_years(const attribute_bitmaps_t& aBitmaps, size_t aFirst, size_t aLast)
+{
+    Bitmap result;
+    const auto& years = aBitmaps[static_cast<size_t>(attribute::year)];
+    const auto last = fmt::format("{:04d}", aLast);
+    for (auto year = years.lower_bound(fmt::format("{:04d}", aFirst)); year != years.end() && year->first <= last; ++year)
+        result |= year->second;
+    return result;
+
+} // hidb::BitmapIndex::of_years
+
+// ----------------------------------------------------------------------
+
+hidb::Bitmap hidb::BitmapIndex::make(std::vector<uint32_t>&& aIndexes)
+{
+    std::sort(aIndexes.begin(), aIndexes.end());
+    Bitmap result;
+    for (const auto index : aIndexes)
+        result.add(index); // duplicates are ignored
+    return result;
+
+} // hidb::BitmapIndex::make
+
+// ----------------------------------------------------------------------
+
+hidb::Bitmap hidb::BitmapIndex::antigens_in(const Bitmap& aTables) const
+{
+    const auto tables = bin::tables(mHiDb.data());
+    std::vector<bin::antigen_index_t> indexes;
+    aTables.for_each([&](uint32_t table_no) { indexes.insert(indexes.end(), tables[table_no].antigen_begin(), tables[table_no].antigen_end()); });
+    return make(std::move(indexes));
+
+} // hidb::BitmapIndex::antigens_in
+
+// ----------------------------------------------------------------------
+
+hidb::Bitmap hidb::BitmapIndex::sera_in(const Bitmap& aTables) const
+{
+    const auto tables = bin::tables(mHiDb.data());
+    std::vector<bin::serum_index_t> indexes;
+    aTables.for_each([&](uint32_t table_no) { indexes.insert(indexes.end(), tables[table_no].serum_begin(), tables[table_no].serum_end()); });
+    return make(std::move(indexes));
+
+} // hidb::BitmapIndex::sera_in
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
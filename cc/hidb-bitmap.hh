@@ -0,0 +1,132 @@
+#pragma once
+
+#include <map>
+#include <array>
+
+#include "hidb-5/hidb-range.hh"
+
+// ----------------------------------------------------------------------
+// Bitmaps of antigens, sera and tables by categorical attributes, questions become intersections instead of scans:
+//
+//   const auto bitmaps = hidb.bitmaps();
+//   const auto vidrl_fra = bitmaps->tables(attribute::lab, "VIDRL") & bitmaps->tables(attribute::assay, "FRA");
+//   const auto found = bitmaps->antigens(attribute::lineage, "VICTORIA") & bitmaps->antigens(range::passage_class::cell) & bitmaps->antigens_of_years(2019, 9999) & bitmaps->antigens_in(vidrl_fra);
+//   found.for_each([](uint32_t antigen_no) { ... });
+// ----------------------------------------------------------------------
+
+namespace hidb
+{
+      // Compressed set of antigen, serum or table indexes (roaring-style): indexes are split into chunks by their upper 16 bits,
+      // a chunk of at most array_limit indexes is a sorted array of their lower 16 bits, a denser chunk is a set of 65536 bits
+    class Bitmap
+    {
+     public:
+        constexpr static const size_t array_limit = 4096;
+
+        void add(uint32_t aIndex); // adding indexes in increasing order is the fastest
+        bool contains(uint32_t aIndex) const;
+        size_t size() const;
+        bool empty() const { return chunks_.empty(); }
+        std::vector<uint32_t> to_vector() const; // sorted
+
+        template <typename F> void for_each(F&& aF) const // in increasing order
+            {
+                for (const auto& chunk : chunks_) {
+                    const auto high = static_cast<uint32_t>(chunk.key) << 16;
+                    if (chunk.has_bits()) {
+                        for (size_t word = 0; word < chunk.bits.size(); ++word) {
+                            for (auto bits = chunk.bits[word]; bits != 0; bits &= bits - 1)
+                                aF(high | static_cast<uint32_t>(word * 64 + static_cast<size_t>(__builtin_ctzll(bits))));
+                        }
+                    }
+                    else {
+                        for (const auto low : chunk.array)
+                            aF(high | low);
+                    }
+                }
+            }
+
+        Bitmap operator&(const Bitmap& aOther) const;
+        Bitmap operator|(const Bitmap& aOther) const;
+        Bitmap& operator&=(const Bitmap& aOther) { return *this = *this & aOther; }
+        Bitmap& operator|=(const Bitmap& aOther) { return *this = *this | aOther; }
+
+     private:
+        struct Chunk
+        {
+            constexpr static const size_t number_of_words = 65536 / 64;
+
+            Chunk(uint16_t aKey) : key{aKey} {}
+
+            uint16_t key;
+            size_t size = 0;
+            std::vector<uint16_t> array; // sorted lower 16 bits of indexes, if size <= array_limit
+            std::vector<uint64_t> bits;  // number_of_words, if size > array_limit
+
+            bool has_bits() const { return !bits.empty(); }
+            bool contains(uint16_t aLow) const;
+            void add(uint16_t aLow);
+            void to_bits();
+            void to_array();
+        };
+
+        std::vector<Chunk> chunks_; // sorted by key, no empty chunks
+
+        static Chunk intersection(const Chunk& aChunk1, const Chunk& aChunk2);
+        static Chunk union_of(const Chunk& aChunk1, const Chunk& aChunk2);
+
+    }; // class Bitmap
+
+      // ----------------------------------------------------------------------
+
+    enum class attribute { lab, assay, rbc, lineage, year, host };
+
+      // Bitmaps made by HiDb::bitmaps() on first use with a single pass over antigens, sera and tables
+      // antigens (sera) by lab, assay and rbc of their tables, lineage (VICTORIA, YAMAGATA, only the first letter is compared), isolation year (e.g. 2019),
+      // host (as stored in hidb5b) and passage class (see range::passage_class); tables by lab, assay and rbc
+      // assay is HI, FR (also FRA, FOCUS REDUCTION), PRN (also PRNT, PLAQUE REDUCTION NEUTRALISATION); rbc is turkey, guinea-pig, chicken (also tu, gp, ch), see normalize()
+    class BitmapIndex
+    {
+     public:
+        BitmapIndex(const HiDb& aHiDb);
+
+          // empty bitmap if no antigen (serum, table) has aValue
+        const Bitmap& antigens(attribute aAttribute, std::string_view aValue) const { return find(mAntigens, aAttribute, aValue); }
+        const Bitmap& sera(attribute aAttribute, std::string_view aValue) const { return find(mSera, aAttribute, aValue); }
+        const Bitmap& tables(attribute aAttribute, std::string_view aValue) const { return find(mTables, aAttribute, aValue); }
+        const Bitmap& antigens(range::passage_class aClass) const { return mAntigenPassages[static_cast<size_t>(aClass)]; }
+        const Bitmap& sera(range::passage_class aClass) const { return mSerumPassages[static_cast<size_t>(aClass)]; }
+
+          // isolated in aFirst..aLast (inclusive)
+        Bitmap antigens_of_years(size_t aFirst, size_t aLast) const { return of_years(mAntigens, aFirst, aLast); }
+        Bitmap sera_of_years(size_t aFirst, size_t aLast) const { return of_years(mSera, aFirst, aLast); }
+
+          // antigens (sera) of aTables, just these tables are looked at
+        Bitmap antigens_in(const Bitmap& aTables) const;
+        Bitmap sera_in(const Bitmap& aTables) const;
+
+     private:
+        using bitmaps_t = std::map<std::string, Bitmap, std::less<>>;
+        constexpr static const size_t number_of_attributes = static_cast<size_t>(attribute::host) + 1;
+        using attribute_bitmaps_t = std::array<bitmaps_t, number_of_attributes>;
+
+        const HiDb& mHiDb;
+        attribute_bitmaps_t mAntigens;
+        attribute_bitmaps_t mSera;
+        attribute_bitmaps_t mTables;
+        std::array<Bitmap, 3> mAntigenPassages;
+        std::array<Bitmap, 3> mSerumPassages;
+
+        static const Bitmap& find(const attribute_bitmaps_t& aBitmaps, attribute aAttribute, std::string_view aValue);
+        static Bitmap of_years(const attribute_bitmaps_t& aBitmaps, size_t aFirst, size_t aLast);
+        static Bitmap make(std::vector<uint32_t>&& aIndexes);
+        static std::string normalize(attribute aAttribute, std::string_view aValue);
+
+    }; // class BitmapIndex
+
+} // namespace hidb
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -0,0 +1,115 @@
+#include <cstring>
+#include <algorithm>
+
+#include "acmacs-base/fmt.hh"
+#include "hidb-5/hidb-homologous-titers.hh"
+#include "hidb-5/hidb-parallel.hh"
+
+// ----------------------------------------------------------------------
+
+static inline size_t data_size(size_t aNumberOfSera, size_t aNumberOfEntries)
+{
+    return sizeof(hidb::HomologousTiters::Header) + sizeof(uint64_t) * (aNumberOfSera + 1) + sizeof(hidb::HomologousTiters::entry_t) * aNumberOfEntries;
+}
+
+// ----------------------------------------------------------------------
+
+std::string hidb::HomologousTiters::signature()
+{
+    return "HIDB5HOM";
+
+} // hidb::HomologousTiters::signature
+
+// ----------------------------------------------------------------------
+
+hidb::HomologousTiters::HomologousTiters(std::string_view aFilename, const HiDb& aHiDb)
+{
+    acmacs::file::read_access access(aFilename);
+    const auto sig = signature();
+    if (access.size() < sizeof(Header) || std::memcmp(access.data(), sig.data(), sig.size()) != 0)
+        throw std::runtime_error(fmt::format("[hidb] not a homologous titers file: {}", aFilename));
+    mAccess = std::move(access);
+    mData = mAccess.data();
+    if (mAccess.size() < data_size(number_of_sera(), number_of_entries()))
+        throw std::runtime_error(fmt::format("[hidb] truncated homologous titers file: {}", aFilename));
+    if (virus_type() != aHiDb.virus_type() || header().source != aHiDb.fingerprint())
+        throw std::runtime_error(fmt::format("[hidb] homologous titers file {} was made from another hidb (virus type: {}), re-make it with hidb5-homologous-titers", aFilename, virus_type()));
+
+} // hidb::HomologousTiters::HomologousTiters
+
+// ----------------------------------------------------------------------
+
+hidb::HomologousTiters::HomologousTiters(const HiDb& aHiDb, size_t aThreads)
+{
+    const auto tables = bin::tables(aHiDb.data());
+    const auto sera = bin::sera(aHiDb.data());
+    const auto table_refs = aHiDb.table_refs();
+    const auto hidb_tables = aHiDb.tables();
+
+    std::vector<bin::date_t> dates(tables.size()); // numeric dates (TBND section), parsed just for old hidb5b
+    for (size_t table_no = 0; table_no < tables.size(); ++table_no)
+        dates[table_no] = hidb_tables->date(TableIndex{table_no}).date;
+
+      // sera are split into consecutive chunks, series of each thread are concatenated in thread order afterwards
+    const auto threads = number_of_threads(aThreads, sera.size());
+    std::vector<std::vector<entry_t>> entries_of_thread(threads);
+    std::vector<uint64_t> offsets(sera.size() + 1, 0);
+    parallel_chunks(sera.size(), threads, [&](size_t thread_no, size_t first, size_t last) {
+        auto& target = entries_of_thread[thread_no];
+        for (size_t serum_index = first; serum_index < last; ++serum_index) {
+            const auto& serum = sera[serum_index];
+            const auto [num_homologous, homologous] = serum.homologous_antigens();
+            const auto [num_tables, table_indexes] = serum.tables();
+            const auto series_start = target.size();
+            for (const auto* table_no = table_indexes; num_homologous > 0 && table_no != table_indexes + num_tables; ++table_no) {
+                const auto& table = tables[*table_no];
+                const auto serum_no = table.serum_no(static_cast<bin::serum_index_t>(serum_index));
+                if (serum_no == table.number_of_sera())
+                    continue;
+                const auto titers = table_refs[TableIndex{*table_no}];
+                for (const auto* antigen_index = homologous; antigen_index != homologous + num_homologous; ++antigen_index) {
+                    if (const auto antigen_no = table.antigen_no(*antigen_index); antigen_no < table.number_of_antigens()) {
+                        if (const auto titer = titers.titer_numeric(antigen_no, serum_no); !titer.is_dont_care()) {
+                            target.push_back(entry_t{*table_no, dates[*table_no], *antigen_index, titer, 0});
+                            break;
+                        }
+                    }
+                }
+            }
+            std::sort(target.begin() + static_cast<std::ptrdiff_t>(series_start), target.end(), [](const auto& e1, const auto& e2) { return e1.date == e2.date ? e1.table < e2.table : e1.date < e2.date; });
+            offsets[serum_index + 1] = target.size() - series_start;
+        }
+    });
+    for (size_t serum_index = 0; serum_index < sera.size(); ++serum_index)
+        offsets[serum_index + 1] += offsets[serum_index];
+
+    mDataStorage.resize(data_size(sera.size(), offsets.back()), 0);
+    mData = mDataStorage.data();
+    auto* header = reinterpret_cast<Header*>(mDataStorage.data());
+    const auto sig = signature();
+    std::memmove(header->signature, sig.data(), sig.size());
+    const auto virus_type = aHiDb.virus_type();
+    header->virus_type_size = static_cast<uint8_t>(std::min(virus_type.size(), sizeof(header->virus_type_)));
+    std::memmove(header->virus_type_, virus_type.data(), header->virus_type_size);
+    header->number_of_sera = static_cast<uint32_t>(sera.size());
+    header->number_of_entries = offsets.back();
+    header->source = aHiDb.fingerprint();
+    std::memmove(mDataStorage.data() + sizeof(Header), offsets.data(), sizeof(uint64_t) * offsets.size());
+    auto* target = const_cast<entry_t*>(entries());
+    for (const auto& entries_of_chunk : entries_of_thread)
+        target = std::copy(entries_of_chunk.begin(), entries_of_chunk.end(), target);
+
+} // hidb::HomologousTiters::HomologousTiters
+
+// ----------------------------------------------------------------------
+
+void hidb::HomologousTiters::save(std::string_view aFilename) const
+{
+    acmacs::file::write(aFilename, std::string_view{mData, data_size(number_of_sera(), number_of_entries())});
+
+} // hidb::HomologousTiters::save
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "hidb-5/hidb.hh"
+
+// ----------------------------------------------------------------------
+
+namespace hidb
+{
+      // Titer of each serum against its homologous antigen in every table where both are present, i.e. serum potency time series
+      // series of each serum is sorted by table date, then by table index
+    class HomologousTiters
+    {
+     public:
+        struct entry_t
+        {
+            bin::table_index_t table;
+            bin::date_t date; // table date: 20160602, 0 if table date is unrecognized
+            bin::antigen_index_t antigen; // homologous antigen, the first one of bin::Serum::homologous_antigens() having titer in the table
+            bin::titer_t titer;
+            uint16_t _padding1;
+        };
+
+        HomologousTiters(const HiDb& aHiDb, size_t aThreads = 0); // aThreads == 0: number of cpus
+        HomologousTiters(std::string_view aFilename, const HiDb& aHiDb); // reads file written by save(), uncompressed file is memory mapped, throws if file was made from another hidb
+
+        std::string_view virus_type() const { return {header().virus_type_, header().virus_type_size}; }
+        size_t number_of_sera() const { return header().number_of_sera; }
+        size_t number_of_entries() const { return header().number_of_entries; }
+        std::pair<size_t, const entry_t*> of(SerumIndex aSerum) const { const auto* offsets = serum_offsets(); return {offsets[*aSerum + 1] - offsets[*aSerum], entries() + offsets[*aSerum]}; }
+
+        void save(std::string_view aFilename) const;
+
+        struct Header
+        {
+            char signature[8];
+            uint8_t virus_type_size;
+            char virus_type_[7];
+            uint32_t number_of_sera;
+            uint32_t _padding1;
+            uint64_t number_of_entries;
+            bin::Fingerprint source; // of hidb5b the file was made from
+        };
+
+        static std::string signature();
+
+     private:
+        const char* mData = nullptr;
+        std::string mDataStorage;
+        acmacs::file::read_access mAccess;
+
+        const Header& header() const { return *reinterpret_cast<const Header*>(mData); }
+        const uint64_t* serum_offsets() const { return reinterpret_cast<const uint64_t*>(mData + sizeof(Header)); }
+        const entry_t* entries() const { return reinterpret_cast<const entry_t*>(mData + sizeof(Header) + sizeof(uint64_t) * (number_of_sera() + 1)); }
+
+    }; // class HomologousTiters
+
+    static_assert(sizeof(HomologousTiters::entry_t) == 16);
+
+} // namespace hidb
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -1,4 +1,5 @@
 #include <map>
+#include <algorithm>
 #include <cstring>
 #include <limits>
 
@@ -7,6 +8,7 @@
 #include "acmacs-base/rjson-v2.hh"
 #include "hidb-5/hidb-json.hh"
 #include "hidb-5/hidb-bin.hh"
+#include "hidb-5/hidb-sections.hh"
 
 // ----------------------------------------------------------------------
 
@@ -37,9 +39,10 @@ class Estimations
 
 // ----------------------------------------------------------------------
 
-static size_t make_antigen(const rjson::value& aSource, hidb::bin::Antigen* aTarget);
-static size_t make_serum(const rjson::value& aSource, hidb::bin::Serum* aTarget);
-static size_t make_table(const rjson::value& aSource, hidb::bin::Table* aTarget);
+static std::string make_strings(const rjson::value& aSource);
+static size_t make_antigen(const rjson::value& aSource, const hidb::bin::Strings& aStrings, hidb::bin::Antigen* aTarget);
+static size_t make_serum(const rjson::value& aSource, const hidb::bin::Strings& aStrings, hidb::bin::Serum* aTarget);
+static size_t make_table(const rjson::value& aSource, const hidb::bin::Strings& aStrings, hidb::bin::Table* aTarget);
 
 // ----------------------------------------------------------------------
 
@@ -52,6 +55,11 @@ std::string hidb::json::read(std::string aData, bool verbose)
 
     std::string result(estimations.size, 0);
 
+    Timeit ti_strings("making string dictionary: ", do_report_time(verbose));
+    auto strings_data = make_strings(val);
+    const hidb::bin::Strings strings{strings_data};
+    ti_strings.report();
+
     auto* const data_start = const_cast<char*>(result.data());
     auto* const header_bin = reinterpret_cast<hidb::bin::Header*>(data_start);
     std::string sig = hidb::bin::signature();
@@ -71,8 +79,8 @@ std::string hidb::json::read(std::string aData, bool verbose)
     *antigen_offset = 0;
     ++antigen_offset;
     hidb::bin::ast_offset_t previous_antigen_offset = 0;
-    rjson::for_each(val["a"], [&antigen_data, &antigen_offset, &previous_antigen_offset](const rjson::value& antigen) {
-        const auto ag_size = make_antigen(antigen, reinterpret_cast<hidb::bin::Antigen*>(antigen_data));
+    rjson::for_each(val["a"], [&antigen_data, &antigen_offset, &previous_antigen_offset, &strings](const rjson::value& antigen) {
+        const auto ag_size = make_antigen(antigen, strings, reinterpret_cast<hidb::bin::Antigen*>(antigen_data));
         *antigen_offset = static_cast<hidb::bin::ast_offset_t>(ag_size) + previous_antigen_offset;
         previous_antigen_offset = *antigen_offset;
         ++antigen_offset;
@@ -90,8 +98,8 @@ std::string hidb::json::read(std::string aData, bool verbose)
     *serum_offset = 0;
     ++serum_offset;
     hidb::bin::ast_offset_t previous_serum_offset = 0;
-    rjson::for_each(val["s"], [&serum_data, &serum_offset, &previous_serum_offset](const rjson::value& serum) {
-        const auto sr_size = make_serum(serum, reinterpret_cast<hidb::bin::Serum*>(serum_data));
+    rjson::for_each(val["s"], [&serum_data, &serum_offset, &previous_serum_offset, &strings](const rjson::value& serum) {
+        const auto sr_size = make_serum(serum, strings, reinterpret_cast<hidb::bin::Serum*>(serum_data));
         *serum_offset = static_cast<hidb::bin::ast_offset_t>(sr_size) + previous_serum_offset;
         previous_serum_offset = *serum_offset;
         ++serum_offset;
@@ -109,8 +117,8 @@ std::string hidb::json::read(std::string aData, bool verbose)
     *table_offset = 0;
     ++table_offset;
     hidb::bin::ast_offset_t previous_table_offset = 0;
-    rjson::for_each(val["t"], [&table_data, &table_offset, &previous_table_offset](const rjson::value& table) {
-        const auto table_size = make_table(table, reinterpret_cast<hidb::bin::Table*>(table_data));
+    rjson::for_each(val["t"], [&table_data, &table_offset, &previous_table_offset, &strings](const rjson::value& table) {
+        const auto table_size = make_table(table, strings, reinterpret_cast<hidb::bin::Table*>(table_data));
         *table_offset = static_cast<hidb::bin::ast_offset_t>(table_size) + previous_table_offset;
         previous_table_offset = *table_offset;
         ++table_offset;
@@ -127,13 +135,61 @@ std::string hidb::json::read(std::string aData, bool verbose)
     else if (verbose)
         std::cerr << "size estimation extra: " << (estimations.size - result.size()) << " bytes " << std::fixed << std::setprecision(1) << (100.0 * static_cast<double>(estimations.size - result.size()) / static_cast<double>(result.size()))
                   << "%\n";
+
+      // hidb5.json made before titers were stored in the order of table antigen and serum indexes has no titer order
+    uint32_t format_flags = 0;
+    if (const auto& titer_order = val["  titer-order"]; titer_order.empty() || titer_order.to<std::string_view>() != "index") {
+        format_flags = hidb::bin::format_flag_titers_in_chart_order;
+        std::cerr << "WARNING: titers in hidb5.json are in the order of the source charts, hidb will refuse to read them, re-make hidb5.json with hidb5-make\n";
+    }
+    hidb::sections::append(result, format_flags, std::move(strings_data), verbose);
     return result;
 
 } // hidb::json::read
 
 // ----------------------------------------------------------------------
 
-size_t make_antigen(const rjson::value& aSource, hidb::bin::Antigen* aTarget)
+  // host, location, passage, serum species, assay, lab and rbc of all antigens, sera and tables, STRS section data (see hidb::bin::Strings)
+std::string make_strings(const rjson::value& aSource)
+{
+    std::vector<std::string_view> strings{std::string_view{}};
+    const auto add = [&strings](const rjson::value& aRecord, std::initializer_list<const char*> aKeys) {
+        for (const auto* key : aKeys) {
+            if (const auto& field = aRecord[key]; !field.empty())
+                strings.push_back(field.to<std::string_view>());
+        }
+    };
+    rjson::for_each(aSource["a"], [&add](const rjson::value& antigen) { add(antigen, {"H", "O", "P"}); });
+    rjson::for_each(aSource["s"], [&add](const rjson::value& serum) { add(serum, {"H", "O", "P", "s"}); });
+    rjson::for_each(aSource["t"], [&add](const rjson::value& table) { add(table, {"A", "l", "r"}); });
+    std::sort(strings.begin(), strings.end());
+    strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+
+    std::vector<uint32_t> offsets(strings.size() + 1, 0);
+    std::string characters;
+    for (size_t no = 0; no < strings.size(); ++no) {
+        characters.append(strings[no]);
+        offsets[no + 1] = static_cast<uint32_t>(characters.size());
+    }
+    std::string result(sizeof(uint32_t) * (offsets.size() + 1), 0);
+    *reinterpret_cast<uint32_t*>(result.data()) = static_cast<uint32_t>(strings.size());
+    std::memmove(result.data() + sizeof(uint32_t), offsets.data(), sizeof(uint32_t) * offsets.size());
+    result.append(characters);
+    return result;
+
+} // make_strings
+
+// ----------------------------------------------------------------------
+
+  // id of the value of aField in aStrings made by make_strings(), 0 (empty string) if aField is absent
+inline hidb::bin::string_id_t string_id(const rjson::value& aField, const hidb::bin::Strings& aStrings)
+{
+    return aField.empty() ? hidb::bin::string_id_t{0} : aStrings.find(aField.to<std::string_view>());
+}
+
+// ----------------------------------------------------------------------
+
+size_t make_antigen(const rjson::value& aSource, const hidb::bin::Strings& aStrings, hidb::bin::Antigen* aTarget)
 {
     if (const auto& year = aSource["y"]; year.size() == 4)
         std::memmove(aTarget->year_data, year.to<std::string_view>().data(), 4);
@@ -153,19 +209,14 @@ size_t make_antigen(const rjson::value& aSource, hidb::bin::Antigen* aTarget)
     };
 
     auto* target = target_base;
-    if (const auto& host = aSource["H"]; !host.empty()) {
-        std::memmove(target, host.to<std::string_view>().data(), host.size());
-        target += host.size();
-    }
-    if (const auto& location = aSource["O"]; !location.empty()) {
-        std::memmove(target, location.to<std::string_view>().data(), location.size());
-        set_offset(aTarget->location_offset, target);
-        target += location.size();
-    }
-    else {
+    if (aSource["O"].empty())
         AD_WARNING("empty location in {}\n", aSource);
-    }
+      // host, location and passage are stored as ids, see make_strings()
+    const hidb::bin::AntigenStringIds ids{string_id(aSource["H"], aStrings), string_id(aSource["O"], aStrings), string_id(aSource["P"], aStrings)};
+    std::memmove(target, &ids, sizeof(ids));
+    target += sizeof(ids);
 
+    set_offset(aTarget->location_offset, target);
     set_offset(aTarget->isolation_offset, target);
     if (const auto& isolation = aSource["i"]; !isolation.empty()) {
         std::memmove(target, isolation.to<std::string_view>().data(), isolation.size());
@@ -176,11 +227,6 @@ size_t make_antigen(const rjson::value& aSource, hidb::bin::Antigen* aTarget)
     }
 
     set_offset(aTarget->passage_offset, target);
-    if (const auto& passage = aSource["P"]; !passage.empty()) {
-        std::memmove(target, passage.to<std::string_view>().data(), passage.size());
-        target += passage.size();
-    }
-
     set_offset(aTarget->reassortant_offset, target);
     if (const auto& reassortant = aSource["R"]; !reassortant.empty()) {
         std::memmove(target, reassortant.to<std::string_view>().data(), reassortant.size());
@@ -253,7 +299,7 @@ size_t make_antigen(const rjson::value& aSource, hidb::bin::Antigen* aTarget)
 
 // ----------------------------------------------------------------------
 
-size_t make_serum(const rjson::value& aSource, hidb::bin::Serum* aTarget)
+size_t make_serum(const rjson::value& aSource, const hidb::bin::Strings& aStrings, hidb::bin::Serum* aTarget)
 {
     if (const auto& year = aSource["y"]; year.size() == 4)
         std::memmove(aTarget->year_data, year.to<std::string_view>().data(), 4);
@@ -274,21 +320,12 @@ size_t make_serum(const rjson::value& aSource, hidb::bin::Serum* aTarget)
 
     auto* target = target_base;
 
-    if (const auto& host = aSource["H"]; !host.empty()) {
-        std::memmove(target, host.to<std::string_view>().data(), host.size());
-        target += host.size();
-    }
+      // host, location, passage and serum species are stored as ids, see make_strings(), location is empty if name was not recognized
+    const hidb::bin::SerumStringIds ids{string_id(aSource["H"], aStrings), string_id(aSource["O"], aStrings), string_id(aSource["P"], aStrings), string_id(aSource["s"], aStrings)};
+    std::memmove(target, &ids, sizeof(ids));
+    target += sizeof(ids);
 
     set_offset(aTarget->location_offset, target);
-    if (const auto& location = aSource["O"]; !location.empty()) {
-        std::memmove(target, location.to<std::string_view>().data(), location.size());
-        target += location.size();
-    }
-      // location is empty if name was not recognized
-    // else {
-    //     std::cerr << "WARNING: empty location in " << aSource << '\n';
-    // }
-
     set_offset(aTarget->isolation_offset, target);
     if (const auto& isolation = aSource["i"]; !isolation.empty()) {
         std::memmove(target, isolation.to<std::string_view>().data(), isolation.size());
@@ -299,11 +336,6 @@ size_t make_serum(const rjson::value& aSource, hidb::bin::Serum* aTarget)
     }
 
     set_offset(aTarget->passage_offset, target);
-    if (const auto& passage = aSource["P"]; !passage.empty()) {
-        std::memmove(target, passage.to<std::string_view>().data(), passage.size());
-        target += passage.size();
-    }
-
     set_offset(aTarget->reassortant_offset, target);
     if (const auto& reassortant = aSource["R"]; !reassortant.empty()) {
         std::memmove(target, reassortant.to<std::string_view>().data(), reassortant.size());
@@ -330,10 +362,6 @@ size_t make_serum(const rjson::value& aSource, hidb::bin::Serum* aTarget)
     }
 
     set_offset(aTarget->serum_species_offset, target);
-    if (const auto& serum_species = aSource["s"]; !serum_species.empty()) {
-        std::memmove(target, serum_species.to<std::string_view>().data(), serum_species.size());
-        target += serum_species.size();
-    }
 
       // padding
     if (size_t size = static_cast<size_t>(target - target_base); size % 4)
@@ -369,7 +397,7 @@ size_t make_serum(const rjson::value& aSource, hidb::bin::Serum* aTarget)
 
 // ----------------------------------------------------------------------
 
-size_t make_table(const rjson::value& aSource, hidb::bin::Table* aTarget)
+size_t make_table(const rjson::value& aSource, const hidb::bin::Strings& aStrings, hidb::bin::Table* aTarget)
 {
     if (const auto& lineage = aSource["L"]; lineage.size() == 1)
         aTarget->lineage = lineage.to<std::string_view>()[0];
@@ -386,10 +414,10 @@ size_t make_table(const rjson::value& aSource, hidb::bin::Table* aTarget)
 
     auto* target = target_base;
 
-    if (const auto& assay = aSource["A"]; !assay.empty()) {
-        std::memmove(target, assay.to<std::string_view>().data(), assay.size());
-        target += assay.size();
-    }
+      // assay, lab and rbc are stored as ids, see make_strings()
+    const hidb::bin::TableStringIds ids{string_id(aSource["A"], aStrings), string_id(aSource["l"], aStrings), string_id(aSource["r"], aStrings)};
+    std::memmove(target, &ids, sizeof(ids));
+    target += sizeof(ids);
 
     set_offset(aTarget->date_offset, target);
     if (const auto& date = aSource["D"]; !date.empty()) {
@@ -400,20 +428,10 @@ size_t make_table(const rjson::value& aSource, hidb::bin::Table* aTarget)
         AD_WARNING("table has no date: {}", aSource);
     }
 
-    set_offset(aTarget->lab_offset, target);
-    if (const auto& lab = aSource["l"]; !lab.empty()) {
-        std::memmove(target, lab.to<std::string_view>().data(), lab.size());
-        target += lab.size();
-    }
-    else {
+    if (aSource["l"].empty())
         AD_WARNING("table has no lab: {}", aSource);
-    }
-
+    set_offset(aTarget->lab_offset, target);
     set_offset(aTarget->rbc_offset, target);
-    if (const auto& rbc = aSource["r"]; !rbc.empty()) {
-        std::memmove(target, rbc.to<std::string_view>().data(), rbc.size());
-        target += rbc.size();
-    }
 
       // padding
     if (size_t size = static_cast<size_t>(target - target_base); size % 4)
@@ -528,7 +546,7 @@ void Estimations::antigen(const rjson::value& antigens, bool verbose)
             ++virus_types.emplace(vt.to<std::string_view>(), 0).first->second;
     });
 
-    antigen_size = ag_max_all + sizeof(hidb::bin::Antigen) + ag_max_num_dates * sizeof(hidb::bin::date_t)
+    antigen_size = ag_max_all + sizeof(hidb::bin::Antigen) + sizeof(hidb::bin::AntigenStringIds) + ag_max_num_dates * sizeof(hidb::bin::date_t)
             + sizeof(hidb::bin::number_of_table_indexes_t) + ag_max_num_table_indexes * sizeof(hidb::bin::table_index_t);
 
     if (verbose) {
@@ -589,7 +607,7 @@ void Estimations::serum(const rjson::value& sera, bool verbose)
             ++virus_types.emplace(vt.to<std::string_view>(), 0).first->second;
     });
 
-    serum_size = sr_max_all + sizeof(hidb::bin::Serum)
+    serum_size = sr_max_all + sizeof(hidb::bin::Serum) + sizeof(hidb::bin::SerumStringIds)
             + sr_max_num_homologous * sizeof(hidb::bin::homologous_t)
             + sizeof(hidb::bin::number_of_table_indexes_t) + sr_max_num_table_indexes * sizeof(hidb::bin::table_index_t);
 
@@ -635,7 +653,7 @@ void Estimations::table(const rjson::value& tables, bool verbose)
     const auto antigens_per_table = antigens / number_of_tables + 1;
     const auto sera_per_table = sera / number_of_tables + 1;
 
-    table_size = sizeof(hidb::bin::Table)
+    table_size = sizeof(hidb::bin::Table) + sizeof(hidb::bin::TableStringIds)
             + fields_size / number_of_tables
             + 1                 // padding
             + sizeof(uint32_t) * antigens_per_table
@@ -20,6 +20,8 @@ void HidbMaker::add(const acmacs::chart::Chart& aChart)
             table->add_antigen(target_antigen);
             antigens_of_table[ag_no] = target_antigen;
         }
+        else
+            table->add_distinct_antigen();
     }
 
     auto source_sera = aChart.sera();
@@ -34,6 +36,8 @@ void HidbMaker::add(const acmacs::chart::Chart& aChart)
                 }
             }
         }
+        else
+            table->add_distinct_serum();
     }
 
 } // HidbMaker::add
@@ -132,7 +136,7 @@ void HidbMaker::save(std::string_view aFilename)
 {
     make_index();
 
-    rjson::value data{rjson::object{{"  version", "hidb-v5"}, {"a", rjson::array{}}, {"s", rjson::array{}}, {"t", rjson::array{}}}};
+    rjson::value data{rjson::object{{"  version", "hidb-v5"}, {"  titer-order", "index"}, {"a", rjson::array{}}, {"s", rjson::array{}}, {"t", rjson::array{}}}};
     export_antigens(data["a"]);
     export_sera(data["s"]);
     export_tables(data["t"]);
@@ -179,6 +183,23 @@ void Table::make_indexes()
     std::transform(serum_ptrs.begin(), serum_ptrs.end(), sera.begin(), [](const auto& ptr) -> size_t { return ptr->index; });
     std::sort(sera.begin(), sera.end());
 
+      // titers are stored in the order of antigen and serum indexes (hidb readers rely on that), distinct antigens and sera are not stored
+    const auto position = [](const Indexes& indexes, size_t index) -> size_t { return static_cast<size_t>(std::lower_bound(indexes.begin(), indexes.end(), index) - indexes.begin()); };
+    Titers reordered;
+    reordered.resize(antigens.size(), std::vector<std::string>(sera.size(), "*"));
+    for (auto [ag_no, antigen] : acmacs::enumerate(chart_antigen_ptrs)) {
+        if (antigen != nullptr) {
+            auto& target_row = reordered[position(antigens, antigen->index)];
+            for (auto [sr_no, serum] : acmacs::enumerate(chart_serum_ptrs)) {
+                if (serum != nullptr) {
+                    if (auto& target = target_row[position(sera, serum->index)]; target == "*")
+                        target = titers[ag_no][sr_no];
+                }
+            }
+        }
+    }
+    titers = std::move(reordered);
+
 } // Table::make_indexes
 
 // ----------------------------------------------------------------------
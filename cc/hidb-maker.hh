@@ -107,6 +107,8 @@ class Table
 
     AntigenPtrs antigen_ptrs;
     SerumPtrs serum_ptrs;
+    std::vector<const Antigen*> chart_antigen_ptrs; // for each antigen of the source chart, nullptr for distinct
+    std::vector<const Serum*> chart_serum_ptrs;     // for each serum of the source chart, nullptr for distinct
     size_t index;
 
     Table(const acmacs::chart::Info& aInfo);
@@ -120,8 +122,10 @@ class Table
         {*rhs.virus, *rhs.virus_type, rhs.subset, rhs.lineage, *rhs.assay, *rhs.lab, *rhs.rbc_species, rhs.date}) < 0; }
 
     void set_titers(const acmacs::chart::Titers& aTiters);
-    void add_antigen(Antigen* aAntigen) { antigen_ptrs.insert(aAntigen); }
-    void add_serum(Serum* aSerum) { serum_ptrs.insert(aSerum); }
+    void add_antigen(Antigen* aAntigen) { antigen_ptrs.insert(aAntigen); chart_antigen_ptrs.push_back(aAntigen); }
+    void add_serum(Serum* aSerum) { serum_ptrs.insert(aSerum); chart_serum_ptrs.push_back(aSerum); }
+    void add_distinct_antigen() { chart_antigen_ptrs.push_back(nullptr); }
+    void add_distinct_serum() { chart_serum_ptrs.push_back(nullptr); }
     void make_indexes();
 
 }; // class Table
@@ -0,0 +1,42 @@
+#include <chrono>
+
+#include "acmacs-base/fmt.hh"
+#include "acmacs-chart-2/factory-import.hh"
+#include "hidb-5/hidb-match-charts.hh"
+#include "hidb-5/hidb-parallel.hh"
+
+// ----------------------------------------------------------------------
+
+std::vector<hidb::chart_match_t> hidb::match_charts(const HiDb& aHiDb, const std::vector<std::string_view>& aFilenames, passage_strictness aPassageStrictness, size_t aThreads)
+{
+      // HiDb is shared read only, Antigens::find_all() and Sera::find_all() do not touch lazily built parts of it (e.g. HiDb::tables())
+    const auto antigens = aHiDb.antigens();
+    const auto sera = aHiDb.sera();
+
+    std::vector<chart_match_t> result(aFilenames.size());
+    parallel_work_stealing(aFilenames.size(), number_of_threads(aThreads, aFilenames.size()), [&](size_t /*thread_no*/, size_t chart_no) {
+        auto& target = result[chart_no];
+        target.filename = std::string{aFilenames[chart_no]};
+        try {
+            const auto start = std::chrono::steady_clock::now();
+            auto chart = acmacs::chart::import_from_file(aFilenames[chart_no]);
+            const auto imported = std::chrono::steady_clock::now();
+            target.import_seconds = std::chrono::duration<double>(imported - start).count();
+            target.antigens = antigens->find_all(*chart->antigens(), aPassageStrictness);
+            target.sera = sera->find_all(*chart->sera());
+            target.match_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - imported).count();
+        }
+        catch (std::exception& err) {
+            target.antigens.clear();
+            target.sera.clear();
+            target.error = fmt::format("{}", err);
+        }
+    });
+    return result;
+
+} // hidb::match_charts
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "hidb-5/hidb.hh"
+
+// ----------------------------------------------------------------------
+
+namespace hidb
+{
+    struct chart_match_t
+    {
+        std::string filename;
+        std::vector<std::optional<AntigenIndex>> antigens; // entry per each antigen of the chart, see Antigens::find_all()
+        std::vector<std::optional<SerumIndex>> sera;       // entry per each serum of the chart, see Sera::find_all()
+        std::string error;                                 // chart import or matching failed, antigens and sera are empty then
+        double import_seconds = 0.0;
+        double match_seconds = 0.0;
+
+        size_t number_of_antigens_found() const { return static_cast<size_t>(std::count_if(antigens.begin(), antigens.end(), [](const auto& found) { return found.has_value(); })); }
+        size_t number_of_sera_found() const { return static_cast<size_t>(std::count_if(sera.begin(), sera.end(), [](const auto& found) { return found.has_value(); })); }
+    };
+
+      // imports each chart and matches its antigens and sera against aHiDb, charts are processed concurrently by a work stealing pool of aThreads (0: number of cpus)
+      // result is in the order of aFilenames, failure of a chart is reported in its chart_match_t::error and does not stop other charts
+    std::vector<chart_match_t> match_charts(const HiDb& aHiDb, const std::vector<std::string_view>& aFilenames, passage_strictness aPassageStrictness = passage_strictness::yes, size_t aThreads = 0);
+
+} // namespace hidb
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
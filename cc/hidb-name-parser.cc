@@ -0,0 +1,121 @@
+#include <algorithm>
+
+#include "acmacs-virus/virus-name-v1.hh"
+#include "locationdb/locdb.hh"
+#include "hidb-5/hidb-name-parser.hh"
+
+// ----------------------------------------------------------------------
+
+namespace
+{
+    inline bool is_virus_type(std::string_view aPart) { return aPart == "B" || (aPart.size() > 3 && aPart.substr(0, 2) == "A(" && aPart.back() == ')'); }
+
+      // non-empty, no lower case letters (split_with_extra would change them), no surrounding spaces
+    inline bool is_canonical(std::string_view aPart)
+    {
+        return !aPart.empty() && aPart.front() != ' ' && aPart.back() != ' ' && std::none_of(aPart.begin(), aPart.end(), [](char cc) { return cc >= 'a' && cc <= 'z'; });
+    }
+
+    inline bool is_year(std::string_view aPart) { return aPart.size() == 4 && std::all_of(aPart.begin(), aPart.end(), [](char cc) { return cc >= '0' && cc <= '9'; }); }
+
+      // TYPE/[HOST/]LOCATION/ISOLATION/YYYY[ extra]
+    inline bool parse_canonical(std::string_view aName, hidb::parsed_name_t& aParsed)
+    {
+        const auto last_slash = aName.rfind('/');
+        if (last_slash == std::string_view::npos)
+            return false;
+        const auto year_end = aName.find(' ', last_slash);
+        const auto year = aName.substr(last_slash + 1, year_end == std::string_view::npos ? std::string_view::npos : year_end - last_slash - 1);
+        if (!is_year(year))
+            return false;
+
+        std::string_view parts[4];
+        size_t number_of_parts = 0;
+        for (std::string_view rest = aName.substr(0, last_slash);;) {
+            if (number_of_parts == 4) // too many parts
+                return false;
+            const auto slash = rest.find('/');
+            parts[number_of_parts++] = rest.substr(0, slash);
+            if (slash == std::string_view::npos)
+                break;
+            rest.remove_prefix(slash + 1);
+        }
+        if (number_of_parts < 3 || !is_virus_type(parts[0]) || !std::all_of(parts + 1, parts + number_of_parts, is_canonical))
+            return false;
+
+        aParsed.recognized = true;
+        aParsed.location = parts[number_of_parts - 2];
+        aParsed.isolation = parts[number_of_parts - 1];
+        aParsed.year = year;
+        return true;
+    }
+
+      // cdc names (XX nnn), LOCATION/ISOLATION and just location have less than two slashes, i.e. no location, isolation and year to split
+    inline bool has_no_year(std::string_view aName) { return std::count(aName.begin(), aName.end(), '/') < 2; }
+
+} // namespace
+
+// ----------------------------------------------------------------------
+
+hidb::parsed_name_t hidb::parse_name(std::string_view aName) noexcept
+{
+    parsed_name_t result;
+    if (parse_canonical(aName, result) || has_no_year(aName)) // split_with_extra() would throw for the latter
+        return result;
+
+    try {
+        std::string virus_type, host, passage, extra;
+        virus_name::split_with_extra(aName, virus_type, host, result.location, result.isolation, result.year, passage, extra);
+        result.recognized = true;
+    }
+    catch (std::exception&) { // virus_name::Unrecognized
+        result = parsed_name_t{};
+    }
+    return result;
+
+} // hidb::parse_name
+
+// ----------------------------------------------------------------------
+
+hidb::parsed_name_t hidb::NameCache::parse(std::string_view aName)
+{
+    std::string key{aName};
+    {
+        std::lock_guard<std::mutex> lock{mAccess};
+        if (const auto found = mNames.find(key); found != mNames.end())
+            return found->second;
+    }
+
+    auto parsed = parse_name(aName); // parse outside of the lock
+    std::lock_guard<std::mutex> lock{mAccess};
+    if (mNames.size() >= max_size)
+        mNames.clear();
+    mNames.emplace(std::move(key), parsed);
+    return parsed;
+
+} // hidb::NameCache::parse
+
+// ----------------------------------------------------------------------
+
+std::string hidb::NameCache::fix_location(std::string_view aLocation)
+{
+    std::string key{aLocation};
+    {
+        std::lock_guard<std::mutex> lock{mAccess};
+        if (const auto found = mLocations.find(key); found != mLocations.end())
+            return found->second;
+    }
+
+    std::string fixed{acmacs::locationdb::get().find_or_throw(aLocation).name}; // failures are not cached, next lookup throws again
+    std::lock_guard<std::mutex> lock{mAccess};
+    if (mLocations.size() >= max_size)
+        mLocations.clear();
+    mLocations.emplace(std::move(key), fixed);
+    return fixed;
+
+} // hidb::NameCache::fix_location
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
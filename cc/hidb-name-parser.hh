@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <mutex>
+#include <unordered_map>
+
+// ----------------------------------------------------------------------
+
+namespace hidb
+{
+    struct parsed_name_t
+    {
+        bool recognized = false; // false if virus_name::split_with_extra() cannot split the name (cdc name, location/isolation, etc.), fields are empty then
+        std::string location;
+        std::string isolation;
+        std::string year;
+    };
+
+      // TYPE/[HOST/]LOCATION/ISOLATION/YYYY[ extra] (i.e. names as stored in hidb) are split in place,
+      // cdc names, LOCATION/ISOLATION and just location are not recognized without parsing,
+      // other names are passed to virus_name::split_with_extra(), never throws
+    parsed_name_t parse_name(std::string_view aName) noexcept;
+
+      // Bounded cache of parsed names and fixed locations, one per HiDb (see HiDb::name_cache()), thread safe.
+      // Batch jobs look up the same strain names again and again, they skip parsing and locationdb lookup then.
+    class NameCache
+    {
+     public:
+        parsed_name_t parse(std::string_view aName);
+        std::string fix_location(std::string_view aLocation); // locationdb name of aLocation, throws as LocDb::find_or_throw() does
+
+        constexpr static const size_t max_size = 100'000; // cache is cleared when it grows above
+
+     private:
+        std::mutex mAccess;
+        std::unordered_map<std::string, parsed_name_t> mNames;
+        std::unordered_map<std::string, std::string> mLocations;
+
+    }; // class NameCache
+
+} // namespace hidb
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
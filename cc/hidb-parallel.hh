@@ -0,0 +1,117 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <optional>
+#include <vector>
+#include <exception>
+#include <algorithm>
+
+// ----------------------------------------------------------------------
+
+namespace hidb
+{
+      // aThreads == 0: number of cpus, never more threads than chunks of work
+    inline size_t number_of_threads(size_t aThreads, size_t aSize)
+    {
+        if (aThreads == 0)
+            aThreads = std::max(std::thread::hardware_concurrency(), 1U);
+        return std::max(std::min(aThreads, aSize), size_t{1});
+    }
+
+      // splits [0, aSize) into consecutive chunks, one per thread, and calls aFunc(thread_no, first, last) for each chunk in its own thread
+      // the first exception thrown by aFunc is rethrown after all threads finish
+    template <typename F> void parallel_chunks(size_t aSize, size_t aThreads, F&& aFunc)
+    {
+        if (aThreads == 1 || aSize < 2) {
+            aFunc(size_t{0}, size_t{0}, aSize);
+            return;
+        }
+
+        std::vector<std::exception_ptr> errors(aThreads);
+        std::vector<std::thread> threads;
+        for (size_t thread_no = 0; thread_no < aThreads; ++thread_no) {
+            threads.emplace_back([&aFunc, &errors, thread_no, first = aSize * thread_no / aThreads, last = aSize * (thread_no + 1) / aThreads]() {
+                try {
+                    aFunc(thread_no, first, last);
+                }
+                catch (...) {
+                    errors[thread_no] = std::current_exception();
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        for (const auto& error : errors) {
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
+
+
+      // calls aFunc(thread_no, item_no) for each item_no in [0, aSize), items are split into consecutive chunks, one per thread,
+      // a thread that finished its own chunk takes items from the end of chunks of other threads (work stealing),
+      // for items taking very different time (e.g. charts of different size)
+      // the first exception thrown by aFunc is rethrown after all threads finish, the remaining items of the failed thread are processed by others
+    template <typename F> void parallel_work_stealing(size_t aSize, size_t aThreads, F&& aFunc)
+    {
+        if (aThreads == 1 || aSize < 2) {
+            for (size_t item_no = 0; item_no < aSize; ++item_no)
+                aFunc(size_t{0}, item_no);
+            return;
+        }
+
+        struct queue_t
+        {
+            std::mutex access;
+            size_t first;
+            size_t last;
+        };
+        std::vector<queue_t> queues(aThreads);
+        for (size_t thread_no = 0; thread_no < aThreads; ++thread_no) {
+            queues[thread_no].first = aSize * thread_no / aThreads;
+            queues[thread_no].last = aSize * (thread_no + 1) / aThreads;
+        }
+        const auto take = [&queues, aThreads](size_t thread_no) -> std::optional<size_t> {
+            {
+                auto& own = queues[thread_no];
+                std::lock_guard<std::mutex> lock{own.access};
+                if (own.first < own.last)
+                    return own.first++;
+            }
+            for (size_t offset = 1; offset < aThreads; ++offset) {
+                auto& victim = queues[(thread_no + offset) % aThreads];
+                std::lock_guard<std::mutex> lock{victim.access};
+                if (victim.first < victim.last)
+                    return --victim.last;
+            }
+            return std::nullopt;
+        };
+
+        std::vector<std::exception_ptr> errors(aThreads);
+        std::vector<std::thread> threads;
+        for (size_t thread_no = 0; thread_no < aThreads; ++thread_no) {
+            threads.emplace_back([&aFunc, &errors, &take, thread_no]() {
+                try {
+                    while (const auto item_no = take(thread_no))
+                        aFunc(thread_no, *item_no);
+                }
+                catch (...) {
+                    errors[thread_no] = std::current_exception();
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        for (const auto& error : errors) {
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
+
+} // namespace hidb
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
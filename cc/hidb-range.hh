@@ -0,0 +1,254 @@
+#pragma once
+
+#include <optional>
+#include <iterator>
+#include <type_traits>
+
+#include "hidb-5/hidb.hh"
+
+// ----------------------------------------------------------------------
+// Lazy range adaptors over HiDb::antigen_refs(), serum_refs(), table_refs() (or any other range with begin() and end()),
+// nothing is materialized until a terminal (count, first, to_vector) is applied:
+//
+//   using namespace hidb::range;
+//   const auto recent_egg_cdc = count(hidb.antigen_refs() | filter(lab(hidb, "CDC")) | filter(passage(passage_class::egg)) | filter(date_window(20180101, 20190101)));
+//   const auto first_name = first(hidb.serum_refs() | filter(in_table(hidb, table_index)) | transform([](auto serum) { return serum.full_name(); }));
+// ----------------------------------------------------------------------
+
+namespace hidb::range
+{
+    template <typename Range> using iterator_of_t = decltype(std::declval<const Range&>().begin());
+    template <typename Range> using value_of_t = std::decay_t<decltype(*std::declval<iterator_of_t<Range>>())>;
+
+      // ----------------------------------------------------------------------
+
+    template <typename Range, typename Pred> class filter_view
+    {
+     public:
+        class iterator
+        {
+         public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = value_of_t<Range>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = decltype(*std::declval<iterator_of_t<Range>>());
+
+            iterator(iterator_of_t<Range> aCurrent, iterator_of_t<Range> aEnd, const Pred* aPred) : current_{aCurrent}, end_{aEnd}, pred_{aPred} { skip(); }
+
+            reference operator*() const { return *current_; }
+            iterator& operator++() { ++current_; skip(); return *this; }
+            iterator operator++(int) { auto result = *this; operator++(); return result; }
+            bool operator==(const iterator& rhs) const { return current_ == rhs.current_; }
+            bool operator!=(const iterator& rhs) const { return current_ != rhs.current_; }
+
+         private:
+            iterator_of_t<Range> current_, end_;
+            const Pred* pred_;
+
+            void skip() { while (current_ != end_ && !(*pred_)(*current_)) ++current_; }
+
+        }; // class iterator
+
+        filter_view(const Range& aRange, Pred aPred) : mRange{aRange}, mPred{std::move(aPred)} {}
+
+        iterator begin() const { return {mRange.begin(), mRange.end(), &mPred}; }
+        iterator end() const { return {mRange.end(), mRange.end(), &mPred}; }
+
+     private:
+        Range mRange;
+        Pred mPred;
+
+    }; // class filter_view<Range, Pred>
+
+      // ----------------------------------------------------------------------
+
+    template <typename Range, typename F> class transform_view
+    {
+     public:
+        class iterator
+        {
+         public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = std::decay_t<std::invoke_result_t<const F&, decltype(*std::declval<iterator_of_t<Range>>())>>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = value_type;
+
+            iterator(iterator_of_t<Range> aCurrent, const F* aFunc) : current_{aCurrent}, func_{aFunc} {}
+
+            value_type operator*() const { return (*func_)(*current_); }
+            iterator& operator++() { ++current_; return *this; }
+            iterator operator++(int) { auto result = *this; ++current_; return result; }
+            bool operator==(const iterator& rhs) const { return current_ == rhs.current_; }
+            bool operator!=(const iterator& rhs) const { return current_ != rhs.current_; }
+
+         private:
+            iterator_of_t<Range> current_;
+            const F* func_;
+
+        }; // class iterator
+
+        transform_view(const Range& aRange, F aFunc) : mRange{aRange}, mFunc{std::move(aFunc)} {}
+
+        iterator begin() const { return {mRange.begin(), &mFunc}; }
+        iterator end() const { return {mRange.end(), &mFunc}; }
+
+     private:
+        Range mRange;
+        F mFunc;
+
+    }; // class transform_view<Range, F>
+
+      // ----------------------------------------------------------------------
+
+    template <typename Range> class take_view
+    {
+     public:
+        class iterator
+        {
+         public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = value_of_t<Range>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = decltype(*std::declval<iterator_of_t<Range>>());
+
+            iterator(iterator_of_t<Range> aCurrent, size_t aLeft) : current_{aCurrent}, left_{aLeft} {}
+
+            reference operator*() const { return *current_; }
+            iterator& operator++() { ++current_; --left_; return *this; }
+            iterator operator++(int) { auto result = *this; operator++(); return result; }
+              // end is reached either when underlying range ends or when nothing is left to take
+            bool operator==(const iterator& rhs) const { return left_ == rhs.left_ || current_ == rhs.current_; }
+            bool operator!=(const iterator& rhs) const { return !operator==(rhs); }
+
+         private:
+            iterator_of_t<Range> current_;
+            size_t left_;
+
+        }; // class iterator
+
+        take_view(const Range& aRange, size_t aNumber) : mRange{aRange}, mNumber{aNumber} {}
+
+        iterator begin() const { return {mRange.begin(), mNumber}; }
+        iterator end() const { return {mRange.end(), 0}; }
+
+     private:
+        Range mRange;
+        size_t mNumber;
+
+    }; // class take_view<Range>
+
+      // ----------------------------------------------------------------------
+      // range | filter(pred) | transform(func) | take(number)
+
+    template <typename Pred> struct filter_t { Pred pred; };
+    template <typename F> struct transform_t { F func; };
+    struct take_t { size_t number; };
+
+    template <typename Pred> inline filter_t<Pred> filter(Pred aPred) { return {std::move(aPred)}; }
+    template <typename F> inline transform_t<F> transform(F aFunc) { return {std::move(aFunc)}; }
+    inline take_t take(size_t aNumber) { return {aNumber}; }
+
+    template <typename Range, typename Pred> inline filter_view<Range, Pred> operator|(const Range& aRange, filter_t<Pred> aFilter) { return {aRange, std::move(aFilter.pred)}; }
+    template <typename Range, typename F> inline transform_view<Range, F> operator|(const Range& aRange, transform_t<F> aTransform) { return {aRange, std::move(aTransform.func)}; }
+    template <typename Range> inline take_view<Range> operator|(const Range& aRange, take_t aTake) { return {aRange, aTake.number}; }
+
+      // ----------------------------------------------------------------------
+      // terminals
+
+    template <typename Range> inline size_t count(const Range& aRange)
+    {
+        size_t result = 0;
+        for (auto it = aRange.begin(), last = aRange.end(); it != last; ++it)
+            ++result;
+        return result;
+    }
+
+    template <typename Range> inline std::optional<value_of_t<Range>> first(const Range& aRange)
+    {
+        if (auto it = aRange.begin(); it != aRange.end())
+            return *it;
+        return std::nullopt;
+    }
+
+    template <typename Range> inline std::vector<value_of_t<Range>> to_vector(const Range& aRange)
+    {
+        std::vector<value_of_t<Range>> result;
+        for (auto&& element : aRange)
+            result.push_back(element);
+        return result;
+    }
+
+      // ----------------------------------------------------------------------
+      // predicates for AntigenRef, SerumRef and TableRef
+
+      // antigen (serum) is in at least one table of aLab, table is of aLab
+      // interned lab ids are compared if hidb5b has them (id of aLab is not found if no table is of aLab)
+    inline auto lab(const HiDb& aHiDb, std::string_view aLab)
+    {
+        const auto& strings = aHiDb.strings();
+        const auto lab_id = strings.find(aLab);
+        auto is_lab = [tables = bin::tables(aHiDb.data()), &strings, lab_id, aLab](size_t table_no) { return strings.empty() ? tables[table_no].lab(strings) == aLab : tables[table_no].string_ids().lab == lab_id; };
+        return [is_lab](const auto& ref) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(ref)>, TableRef>)
+                return is_lab(*ref.index());
+            else
+                return std::any_of(ref.tables().begin(), ref.tables().end(), [&is_lab](bin::table_index_t table_no) { return is_lab(table_no); });
+        };
+    }
+
+      // aLineage: VICTORIA, YAMAGATA (only the first letter is compared, as it is stored in hidb5b), empty for no lineage
+    inline auto lineage(std::string_view aLineage)
+    {
+        return [lineage = aLineage.empty() ? char{0} : aLineage.front()](const auto& ref) { return ref.record().lineage == lineage; };
+    }
+
+      // classified the same way as in vaccines (see hidb::Vaccines::passage_type)
+    enum class passage_class { cell, egg, reassortant };
+
+    template <typename Ref> inline passage_class passage_class_of(const Ref& ref)
+    {
+        if (!ref.reassortant().empty())
+            return passage_class::reassortant;
+        else if (acmacs::virus::Passage{ref.passage()}.is_egg())
+            return passage_class::egg;
+        else
+            return passage_class::cell;
+    }
+
+    inline auto passage(passage_class aClass)
+    {
+        return [aClass](const auto& ref) { return passage_class_of(ref) == aClass; };
+    }
+
+      // antigens with aFirst <= bin::Antigen::date_raw() < aAfterLast
+    inline auto date_window(bin::date_t aFirst, bin::date_t aAfterLast)
+    {
+        return [aFirst, aAfterLast](const AntigenRef& antigen) { const auto date = antigen.date_raw(); return date >= aFirst && date < aAfterLast; };
+    }
+
+      // tables with aFirst <= date < aAfterLast
+    inline auto date_window(bin::TableDate aFirst, bin::TableDate aAfterLast)
+    {
+        return [aFirst, aAfterLast](const TableRef& table) { const auto date = table.date_numeric(); return !(date < aFirst) && date < aAfterLast; };
+    }
+
+      // antigen (serum) is in table aTable
+    inline auto in_table(const HiDb& aHiDb, TableIndex aTable)
+    {
+        return [&table = bin::tables(aHiDb.data())[*aTable]](const auto& ref) {
+            if constexpr (std::is_same_v<std::decay_t<decltype(ref)>, AntigenRef>)
+                return table.antigen_no(static_cast<bin::antigen_index_t>(*ref.index())) < table.number_of_antigens();
+            else
+                return table.serum_no(static_cast<bin::serum_index_t>(*ref.index())) < table.number_of_sera();
+        };
+    }
+
+} // namespace hidb::range
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -0,0 +1,311 @@
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include "acmacs-base/log.hh"
+#include "acmacs-base/fmt.hh"
+#include "acmacs-base/timeit.hh"
+#include "hidb-5/hidb-sections.hh"
+#include "hidb-5/hidb-bin.hh"
+#include "hidb-5/hidb-titer-decoder.hh"
+
+// ----------------------------------------------------------------------
+
+using section_data_t = std::pair<hidb::bin::section_id_t, std::string>;
+
+static std::string make_titers(const char* aData, const hidb::bin::Strings& aStrings);
+static std::string make_table_summaries(const char* aData, std::string_view aTiters);
+template <typename AgSr> static std::string make_name_keys(const hidb::bin::Part<AgSr>& aPart, const hidb::bin::Strings& aStrings);
+template <typename AgSr> static std::string make_location_tree(const hidb::bin::Part<AgSr>& aPart, const hidb::bin::Strings& aStrings);
+template <typename AgSr, typename F> static std::string make_hash_index(const hidb::bin::Part<AgSr>& aPart, F aKeys);
+static std::vector<section_data_t> make_dates(const char* aData);
+static std::string make_homologous_sera(const char* aData);
+static void write(std::string& aData, const std::vector<section_data_t>& aSections);
+
+// ----------------------------------------------------------------------
+
+void hidb::sections::append(std::string& aData, uint32_t aFormatFlags, std::string aStrings, bool verbose)
+{
+    if (hidb::bin::sections(aData.data(), aData.size()) != nullptr)
+        throw std::runtime_error("[hidb] cannot append sections: hidb data already has sections");
+    if (aStrings.empty())
+        throw std::runtime_error("[hidb] cannot append sections: no string dictionary");
+
+    std::vector<section_data_t> sections;
+
+    const hidb::bin::FormatVersion format_version{hidb::bin::current_format_version, aFormatFlags};
+    sections.emplace_back(hidb::bin::section::format_version, std::string(reinterpret_cast<const char*>(&format_version), sizeof(format_version)));
+
+    sections.emplace_back(hidb::bin::section::strings, std::move(aStrings));
+    const hidb::bin::Strings strings{sections.back().second};
+
+    Timeit ti_titers("making numeric titers section: ", do_report_time(verbose));
+    sections.emplace_back(hidb::bin::section::titers, make_titers(aData.data(), strings));
+    ti_titers.report();
+
+    Timeit ti_summaries("making table summaries section: ", do_report_time(verbose));
+    sections.emplace_back(hidb::bin::section::table_summaries, make_table_summaries(aData.data(), sections.back().second));
+    ti_summaries.report();
+
+    Timeit ti_name_keys("making name key sections: ", do_report_time(verbose));
+    sections.emplace_back(hidb::bin::section::antigen_name_keys, make_name_keys(hidb::bin::antigens(aData.data()), strings));
+    sections.emplace_back(hidb::bin::section::serum_name_keys, make_name_keys(hidb::bin::sera(aData.data()), strings));
+    ti_name_keys.report();
+
+    Timeit ti_location_tree("making location tree sections: ", do_report_time(verbose));
+    sections.emplace_back(hidb::bin::section::antigen_location_tree, make_location_tree(hidb::bin::antigens(aData.data()), strings));
+    sections.emplace_back(hidb::bin::section::serum_location_tree, make_location_tree(hidb::bin::sera(aData.data()), strings));
+    ti_location_tree.report();
+
+    Timeit ti_hash("making hash index sections: ", do_report_time(verbose));
+    const auto antigens = hidb::bin::antigens(aData.data());
+    const auto sera = hidb::bin::sera(aData.data());
+    sections.emplace_back(hidb::bin::section::antigen_lab_ids, make_hash_index(antigens, [](const auto& antigen) { return antigen.lab_ids(); }));
+    sections.emplace_back(hidb::bin::section::serum_ids, make_hash_index(sera, [](const auto& serum) { return serum.serum_id().empty() ? std::vector<std::string_view>{} : std::vector<std::string_view>{serum.serum_id()}; }));
+    sections.emplace_back(hidb::bin::section::antigen_full_names, make_hash_index(antigens, [&strings](const auto& antigen) { return std::vector<std::string>{antigen.full_name(strings)}; }));
+    sections.emplace_back(hidb::bin::section::serum_full_names, make_hash_index(sera, [&strings](const auto& serum) { return std::vector<std::string>{serum.full_name(strings)}; }));
+    ti_hash.report();
+
+    Timeit ti_dates("making date sections: ", do_report_time(verbose));
+    for (auto& section : make_dates(aData.data()))
+        sections.push_back(std::move(section));
+    ti_dates.report();
+
+    Timeit ti_homologous("making homologous sera section: ", do_report_time(verbose));
+    sections.emplace_back(hidb::bin::section::homologous_sera, make_homologous_sera(aData.data()));
+    ti_homologous.report();
+
+    Timeit ti_reference("making reference antigens section: ", do_report_time(verbose));
+    sections.emplace_back(hidb::bin::section::reference_antigens, hidb::bin::reference_antigens_section(aData.data(), strings));
+    ti_reference.report();
+
+    Timeit ti_groups("making table groups section: ", do_report_time(verbose));
+    sections.emplace_back(hidb::bin::section::table_groups, hidb::bin::table_groups_section(aData.data(), strings));
+    ti_groups.report();
+
+    Timeit ti_trigrams("making trigram index sections: ", do_report_time(verbose));
+    sections.emplace_back(hidb::bin::section::antigen_trigrams, hidb::bin::antigen_trigrams_section(aData.data(), strings));
+    sections.emplace_back(hidb::bin::section::serum_trigrams, hidb::bin::serum_trigrams_section(aData.data(), strings));
+    ti_trigrams.report();
+
+    Timeit ti_completions("making name completion sections: ", do_report_time(verbose));
+    sections.emplace_back(hidb::bin::section::antigen_completions, hidb::bin::antigen_completions_section(aData.data(), strings));
+    sections.emplace_back(hidb::bin::section::serum_completions, hidb::bin::serum_completions_section(aData.data(), strings));
+    ti_completions.report();
+
+    write(aData, sections);
+    if (verbose)
+        AD_INFO("hidb bin size with sections: {}", aData.size());
+
+} // hidb::sections::append
+
+// ----------------------------------------------------------------------
+
+void write(std::string& aData, const std::vector<section_data_t>& aSections)
+{
+      // sections are aligned at cache line, data is memory mapped
+    const auto align = [](size_t offset) -> size_t { return offset % 64 ? offset + 64 - offset % 64 : offset; };
+
+    const auto header_offset = hidb::bin::sections_offset(aData.data());
+    auto offset = align(header_offset + sizeof(hidb::bin::SectionsHeader) + sizeof(hidb::bin::SectionEntry) * aSections.size());
+    std::vector<hidb::bin::SectionEntry> entries;
+    for (const auto& [id, data] : aSections) {
+        entries.push_back(hidb::bin::SectionEntry{id, static_cast<uint32_t>(offset), static_cast<uint32_t>(data.size())});
+        offset = align(offset + data.size());
+    }
+
+    aData.resize(offset, 0);
+    auto* header = reinterpret_cast<hidb::bin::SectionsHeader*>(aData.data() + header_offset);
+    const std::string sig = hidb::bin::sections_signature();
+    std::memmove(header->signature, sig.data(), sig.size());
+    header->number_of = static_cast<uint32_t>(aSections.size());
+    std::memmove(aData.data() + header_offset + sizeof(hidb::bin::SectionsHeader), entries.data(), sizeof(hidb::bin::SectionEntry) * entries.size());
+    for (size_t no = 0; no < aSections.size(); ++no)
+        std::memmove(aData.data() + entries[no].offset, aSections[no].second.data(), aSections[no].second.size());
+
+} // write
+
+// ----------------------------------------------------------------------
+
+std::string make_titers(const char* aData, const hidb::bin::Strings& aStrings)
+{
+    const auto tables = hidb::bin::tables(aData);
+    std::vector<uint32_t> offsets(tables.size() + 1, 0);
+    for (size_t table_no = 0; table_no < tables.size(); ++table_no)
+        offsets[table_no + 1] = offsets[table_no] + static_cast<uint32_t>(tables[table_no].number_of_antigens() * tables[table_no].number_of_sera());
+
+    std::string result(sizeof(uint32_t) * offsets.size() + sizeof(hidb::bin::titer_t) * offsets.back(), 0);
+    std::memmove(result.data(), offsets.data(), sizeof(uint32_t) * offsets.size());
+    auto* target = reinterpret_cast<hidb::bin::titer_t*>(result.data() + sizeof(uint32_t) * offsets.size());
+    for (size_t table_no = 0; table_no < tables.size(); ++table_no) {
+        const auto& table = tables[table_no];
+        if (const auto invalid = hidb::bin::decode_titers(table, target + offsets[table_no]); invalid > 0)
+            AD_WARNING("{} invalid titers in table {}:{}:{}, stored as dont-care", invalid, table.lab(aStrings), table.assay(aStrings), table.date());
+    }
+    return result;
+
+} // make_titers
+
+// ----------------------------------------------------------------------
+
+std::string make_table_summaries(const char* aData, std::string_view aTiters)
+{
+    const auto tables = hidb::bin::tables(aData);
+    std::string result(sizeof(hidb::bin::TableSummary) * tables.size(), 0);
+    auto* target = reinterpret_cast<hidb::bin::TableSummary*>(result.data());
+    for (size_t table_no = 0; table_no < tables.size(); ++table_no)
+        target[table_no] = hidb::bin::TableSummary::make(hidb::bin::titers_of_table(aTiters, tables.size(), table_no), tables[table_no].number_of_antigens() * tables[table_no].number_of_sera());
+    return result;
+
+} // make_table_summaries
+
+// ----------------------------------------------------------------------
+
+template <typename Ids> inline static std::string as_section(const std::vector<Ids>& aIds)
+{
+    return std::string(reinterpret_cast<const char*>(aIds.data()), sizeof(Ids) * aIds.size());
+}
+
+// ----------------------------------------------------------------------
+
+template <typename AgSr> std::string make_name_keys(const hidb::bin::Part<AgSr>& aPart, const hidb::bin::Strings& aStrings)
+{
+    std::string result(sizeof(hidb::bin::NameKey) * aPart.size(), 0);
+    auto* target = reinterpret_cast<hidb::bin::NameKey*>(result.data());
+    for (size_t no = 0; no < aPart.size(); ++no, ++target) {
+        const auto& rec = aPart[no];
+        const auto location = rec.location(aStrings);
+        std::memmove(target->location, location.data(), std::min(location.size(), hidb::bin::NameKey::location_size));
+        std::memmove(target->isolation, rec.isolation().data(), std::min(rec.isolation().size(), hidb::bin::NameKey::isolation_size));
+        const auto year = rec.year();
+        std::memmove(target->year, year.data(), std::min(year.size(), hidb::bin::NameKey::year_size));
+    }
+    return result;
+
+} // make_name_keys
+
+// ----------------------------------------------------------------------
+
+template <typename AgSr> std::string make_location_tree(const hidb::bin::Part<AgSr>& aPart, const hidb::bin::Strings& aStrings)
+{
+    using node_t = hidb::bin::LocationNode;
+
+      // records are sorted by location, one node per run of records with the same location prefix
+    std::vector<node_t> sorted;
+    for (size_t no = 0; no < aPart.size(); ++no) {
+        node_t node{};
+        const auto location = aPart[no].location(aStrings);
+        std::memmove(node.location, location.data(), std::min(location.size(), node_t::location_size));
+        if (sorted.empty() || std::memcmp(sorted.back().location, node.location, node_t::location_size) != 0) {
+            node.first = static_cast<uint32_t>(no);
+            sorted.push_back(node);
+        }
+        sorted.back().last = static_cast<uint32_t>(no + 1);
+    }
+
+    std::string result(sizeof(node_t) * (sorted.size() + 1), 0);
+    auto* nodes = reinterpret_cast<node_t*>(result.data());
+    nodes[0].first = static_cast<uint32_t>(sorted.size());
+      // in-order traversal of the implicit tree assigns sorted nodes
+    auto source = sorted.begin();
+    const auto fill = [&](size_t node, const auto& self) -> void {
+        if (node <= sorted.size()) {
+            self(node * 2, self);
+            nodes[node] = *source++;
+            self(node * 2 + 1, self);
+        }
+    };
+    fill(1, fill);
+    return result;
+
+} // make_location_tree
+
+// ----------------------------------------------------------------------
+
+template <typename AgSr, typename F> std::string make_hash_index(const hidb::bin::Part<AgSr>& aPart, F aKeys)
+{
+    std::vector<std::pair<uint64_t, uint32_t>> entries; // hash, record index
+    for (size_t no = 0; no < aPart.size(); ++no) {
+        for (const auto& key : aKeys(aPart[no]))
+            entries.emplace_back(hidb::bin::hash(key), static_cast<uint32_t>(no));
+    }
+
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+      // load factor is at most 0.5
+    size_t number_of_slots = 16;
+    while (number_of_slots < entries.size() * 2)
+        number_of_slots *= 2;
+    std::string result(sizeof(uint32_t) * 2 + sizeof(hidb::bin::HashSlot) * number_of_slots, 0);
+    reinterpret_cast<uint32_t*>(result.data())[0] = static_cast<uint32_t>(number_of_slots);
+    reinterpret_cast<uint32_t*>(result.data())[1] = static_cast<uint32_t>(entries.size());
+    auto* slots = reinterpret_cast<hidb::bin::HashSlot*>(result.data() + sizeof(uint32_t) * 2);
+    for (const auto& [hsh, record_no] : entries) {
+        auto slot = static_cast<size_t>(hsh) & (number_of_slots - 1);
+        while (slots[slot].value != 0)
+            slot = (slot + 1) & (number_of_slots - 1);
+        slots[slot] = hidb::bin::HashSlot{static_cast<uint32_t>(hsh >> 32), record_no + 1};
+    }
+    return result;
+
+} // make_hash_index
+
+// ----------------------------------------------------------------------
+
+std::vector<section_data_t> make_dates(const char* aData)
+{
+    const auto antigens = hidb::bin::antigens(aData);
+    const auto tables = hidb::bin::tables(aData);
+
+    std::vector<hidb::bin::TableDate> table_dates(tables.size());
+    std::vector<hidb::bin::DatedTable> tables_by_date(tables.size());
+    for (size_t no = 0; no < tables.size(); ++no) {
+        table_dates[no] = hidb::bin::TableDate::make(tables[no].date());
+        tables_by_date[no] = hidb::bin::DatedTable{table_dates[no], static_cast<hidb::bin::table_index_t>(no)};
+    }
+    std::sort(tables_by_date.begin(), tables_by_date.end(), [](const auto& e1, const auto& e2) { return e1.date == e2.date ? e1.table < e2.table : e1.date < e2.date; });
+
+    std::vector<hidb::bin::DatedAntigen> antigens_by_date(antigens.size());
+    for (size_t no = 0; no < antigens.size(); ++no)
+        antigens_by_date[no] = hidb::bin::DatedAntigen{antigens[no].date_raw(), static_cast<hidb::bin::antigen_index_t>(no)};
+    std::sort(antigens_by_date.begin(), antigens_by_date.end(), [](const auto& e1, const auto& e2) { return e1.date == e2.date ? e1.antigen < e2.antigen : e1.date < e2.date; });
+
+    return {section_data_t{hidb::bin::section::table_dates, as_section(table_dates)}, section_data_t{hidb::bin::section::tables_by_date, as_section(tables_by_date)},
+            section_data_t{hidb::bin::section::antigens_by_date, as_section(antigens_by_date)}};
+
+} // make_dates
+
+// ----------------------------------------------------------------------
+
+std::string make_homologous_sera(const char* aData)
+{
+    const auto number_of_antigens = hidb::bin::antigens(aData).size();
+    const auto sera = hidb::bin::sera(aData);
+
+      // sera are iterated in index order, serum indexes of each antigen are therefore sorted
+    std::vector<uint32_t> offsets(number_of_antigens + 1, 0);
+    for (size_t serum_no = 0; serum_no < sera.size(); ++serum_no) {
+        const auto [num_homologous, homologous] = sera[serum_no].homologous_antigens();
+        for (const auto* antigen_no = homologous; antigen_no != homologous + num_homologous; ++antigen_no)
+            ++offsets[*antigen_no + 1];
+    }
+    for (size_t antigen_no = 0; antigen_no < number_of_antigens; ++antigen_no)
+        offsets[antigen_no + 1] += offsets[antigen_no];
+
+    std::vector<hidb::bin::serum_index_t> serum_indexes(offsets.back());
+    auto next = offsets;
+    for (size_t serum_no = 0; serum_no < sera.size(); ++serum_no) {
+        const auto [num_homologous, homologous] = sera[serum_no].homologous_antigens();
+        for (const auto* antigen_no = homologous; antigen_no != homologous + num_homologous; ++antigen_no)
+            serum_indexes[next[*antigen_no]++] = static_cast<hidb::bin::serum_index_t>(serum_no);
+    }
+
+    return as_section(offsets) + as_section(serum_indexes);
+
+} // make_homologous_sera
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
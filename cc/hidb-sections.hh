@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// ----------------------------------------------------------------------
+
+namespace hidb::sections
+{
+      // makes optional sections (see doc/hidb5-bin-format.txt) using antigens, sera and tables of aData and appends them to aData
+      // records of aData have ids of strings of aStrings (STRS section data, see json::read), it is stored as the STRS section
+      // bin::current_format_version and aFormatFlags are stored in the VERS section, see bin::FormatVersion
+    void append(std::string& aData, uint32_t aFormatFlags, std::string aStrings, bool verbose);
+
+} // namespace hidb::sections
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -0,0 +1,294 @@
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HIDB_TITER_DECODER_X86
+#include <immintrin.h>
+#endif
+
+#include "acmacs-base/fmt.hh"
+#include "hidb-5/hidb-titer-decoder.hh"
+
+// ----------------------------------------------------------------------
+// Vectorized decoders parse each titer (up to 8 bytes) as a little endian uint64:
+//   1. drop prefix (<, >, ~) if present
+//   2. shift digits left by the number of padding bytes, i.e. leading digits become zero bytes
+//   3. combine 8 digits: pairs (*10), then quads (*100), then all (*10000)
+//   4. check that every byte is either zero or a digit
+// The conversion of the value to the log2 scale and the titer type is done per titer by finish().
+// ----------------------------------------------------------------------
+
+namespace
+{
+    using titer_t = hidb::bin::titer_t;
+
+    inline size_t finish(char aFirst, uint64_t aValue, bool aValid, titer_t& aTarget)
+    {
+        auto type = titer_t::regular;
+        switch (aFirst) {
+            case 0:
+            case '*':
+                aTarget = titer_t{};
+                return 0;
+            case '<':
+                type = titer_t::less_than;
+                break;
+            case '>':
+                type = titer_t::more_than;
+                break;
+            case '~':
+                type = titer_t::dodgy;
+                break;
+            default:
+                break;
+        }
+        if (!aValid || aValue == 0) {
+            aTarget = titer_t{};
+            return 1;
+        }
+        aTarget = titer_t::from_value(type, static_cast<size_t>(aValue));
+        return 0;
+    }
+
+      // ----------------------------------------------------------------------
+
+    size_t decode_scalar(const char* aSource, size_t aLength, size_t aNumber, titer_t* aTarget)
+    {
+        size_t invalid = 0;
+        for (size_t no = 0; no < aNumber; ++no, aSource += aLength) {
+            size_t length = aLength;
+            while (length > 0 && !aSource[length - 1])
+                --length;
+            const char first_char = length > 0 ? aSource[0] : '\0';
+            const size_t first = (first_char == '<' || first_char == '>' || first_char == '~') ? 1 : 0;
+            bool valid = first < length && (length - first) <= 19;
+            uint64_t value = 0;
+            for (size_t pos = first; valid && pos < length; ++pos) {
+                if (const auto digit = static_cast<uint64_t>(static_cast<unsigned char>(aSource[pos])) - '0'; digit <= 9)
+                    value = value * 10 + digit;
+                else
+                    valid = false;
+            }
+            invalid += finish(first_char, value, valid, aTarget[no]);
+        }
+        return invalid;
+    }
+
+      // ----------------------------------------------------------------------
+
+#ifdef HIDB_TITER_DECODER_X86
+
+      // titer text (aLength <= 8) as little endian uint64 padded with zeros
+    inline uint64_t load_key(const char* aSource, size_t aLength, const char* aEnd)
+    {
+        uint64_t key = 0;
+        if ((aSource + sizeof(key)) <= aEnd) {
+            std::memcpy(&key, aSource, sizeof(key));
+            if (aLength < sizeof(key))
+                key &= (uint64_t{1} << (aLength * 8)) - 1;
+        }
+        else
+            std::memcpy(&key, aSource, aLength);
+        return key;
+    }
+
+      // ----------------------------------------------------------------------
+
+    __attribute__((target("sse2"))) inline __m128i equal64_sse2(__m128i aSource, int64_t aValue)
+    {
+          // sse2 has no 64 bit comparison
+        const __m128i eq = _mm_cmpeq_epi32(aSource, _mm_set1_epi64x(aValue));
+        return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+
+    __attribute__((target("sse2"))) size_t decode_sse2(const char* aSource, size_t aLength, size_t aNumber, titer_t* aTarget)
+    {
+        const char* const end = aSource + aLength * aNumber;
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i ones = _mm_set1_epi8(1);
+        const __m128i first_byte = _mm_set1_epi64x(0xFF);
+        const __m128i lane0 = _mm_set_epi64x(0, -1);
+        const __m128i ascii_zero = _mm_set1_epi8('0');
+        const __m128i nine = _mm_set1_epi8(9);
+        const __m128i low_nibble = _mm_set1_epi8(0x0F);
+        const __m128i mask_8_of_16 = _mm_set1_epi64x(0x00FF00FF00FF00FF);
+        const __m128i mask_16_of_32 = _mm_set1_epi64x(0x0000FFFF0000FFFF);
+        const __m128i ten = _mm_set1_epi16(10);
+        const __m128i hundred = _mm_set1_epi16(100);
+        const __m128i ten_thousand = _mm_set1_epi64x(10000);
+
+        size_t invalid = 0, no = 0;
+        for (; (no + 2) <= aNumber; no += 2) {
+            alignas(16) uint64_t keys[2] = {load_key(aSource + no * aLength, aLength, end), load_key(aSource + (no + 1) * aLength, aLength, end)};
+            const __m128i key = _mm_load_si128(reinterpret_cast<const __m128i*>(keys));
+
+            const __m128i first = _mm_and_si128(key, first_byte);
+            const __m128i prefix = _mm_or_si128(_mm_or_si128(equal64_sse2(first, '<'), equal64_sse2(first, '>')), equal64_sse2(first, '~'));
+            const __m128i digits = _mm_or_si128(_mm_and_si128(prefix, _mm_srli_epi64(key, 8)), _mm_andnot_si128(prefix, key));
+
+              // sse2 has no per lane variable shift, shift each lane separately
+            const __m128i shift = _mm_slli_epi64(_mm_sad_epu8(_mm_and_si128(_mm_cmpeq_epi8(digits, zero), ones), zero), 3);
+            const __m128i aligned =
+                _mm_or_si128(_mm_and_si128(lane0, _mm_sll_epi64(digits, shift)), _mm_andnot_si128(lane0, _mm_sll_epi64(digits, _mm_unpackhi_epi64(shift, shift))));
+
+            const __m128i is_zero = _mm_cmpeq_epi8(aligned, zero);
+            const __m128i is_digit = _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(aligned, ascii_zero), nine), zero);
+            const int valid = _mm_movemask_epi8(_mm_or_si128(is_zero, is_digit));
+
+            __m128i value = _mm_and_si128(aligned, low_nibble);
+            value = _mm_and_si128(_mm_add_epi16(_mm_mullo_epi16(value, ten), _mm_srli_epi64(value, 8)), mask_8_of_16);
+            value = _mm_and_si128(_mm_add_epi16(_mm_mullo_epi16(value, hundred), _mm_srli_epi64(value, 16)), mask_16_of_32);
+            value = _mm_add_epi64(_mm_mul_epu32(value, ten_thousand), _mm_srli_epi64(value, 32));
+
+            alignas(16) uint64_t values[2];
+            _mm_store_si128(reinterpret_cast<__m128i*>(values), value);
+            invalid += finish(static_cast<char>(keys[0] & 0xFF), values[0], (valid & 0xFF) == 0xFF, aTarget[no]);
+            invalid += finish(static_cast<char>(keys[1] & 0xFF), values[1], ((valid >> 8) & 0xFF) == 0xFF, aTarget[no + 1]);
+        }
+        return invalid + decode_scalar(aSource + no * aLength, aLength, aNumber - no, aTarget + no);
+    }
+
+      // ----------------------------------------------------------------------
+
+    __attribute__((target("avx2"))) size_t decode_avx2(const char* aSource, size_t aLength, size_t aNumber, titer_t* aTarget)
+    {
+        const char* const end = aSource + aLength * aNumber;
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i ones = _mm256_set1_epi8(1);
+        const __m256i first_byte = _mm256_set1_epi64x(0xFF);
+        const __m256i less_than = _mm256_set1_epi64x('<');
+        const __m256i more_than = _mm256_set1_epi64x('>');
+        const __m256i dodgy = _mm256_set1_epi64x('~');
+        const __m256i ascii_zero = _mm256_set1_epi8('0');
+        const __m256i nine = _mm256_set1_epi8(9);
+        const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+        const __m256i mask_8_of_16 = _mm256_set1_epi64x(0x00FF00FF00FF00FF);
+        const __m256i mask_16_of_32 = _mm256_set1_epi64x(0x0000FFFF0000FFFF);
+        const __m256i ten = _mm256_set1_epi16(10);
+        const __m256i hundred = _mm256_set1_epi16(100);
+        const __m256i ten_thousand = _mm256_set1_epi64x(10000);
+
+        size_t invalid = 0, no = 0;
+        for (; (no + 4) <= aNumber; no += 4) {
+            alignas(32) uint64_t keys[4];
+            for (size_t lane = 0; lane < 4; ++lane)
+                keys[lane] = load_key(aSource + (no + lane) * aLength, aLength, end);
+            const __m256i key = _mm256_load_si256(reinterpret_cast<const __m256i*>(keys));
+
+            const __m256i first = _mm256_and_si256(key, first_byte);
+            const __m256i prefix = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi64(first, less_than), _mm256_cmpeq_epi64(first, more_than)), _mm256_cmpeq_epi64(first, dodgy));
+            const __m256i digits = _mm256_blendv_epi8(key, _mm256_srli_epi64(key, 8), prefix);
+
+            const __m256i shift = _mm256_slli_epi64(_mm256_sad_epu8(_mm256_and_si256(_mm256_cmpeq_epi8(digits, zero), ones), zero), 3);
+            const __m256i aligned = _mm256_sllv_epi64(digits, shift);
+
+            const __m256i is_zero = _mm256_cmpeq_epi8(aligned, zero);
+            const __m256i is_digit = _mm256_cmpeq_epi8(_mm256_subs_epu8(_mm256_sub_epi8(aligned, ascii_zero), nine), zero);
+            const auto valid = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(is_zero, is_digit)));
+
+            __m256i value = _mm256_and_si256(aligned, low_nibble);
+            value = _mm256_and_si256(_mm256_add_epi16(_mm256_mullo_epi16(value, ten), _mm256_srli_epi64(value, 8)), mask_8_of_16);
+            value = _mm256_and_si256(_mm256_add_epi16(_mm256_mullo_epi16(value, hundred), _mm256_srli_epi64(value, 16)), mask_16_of_32);
+            value = _mm256_add_epi64(_mm256_mul_epu32(value, ten_thousand), _mm256_srli_epi64(value, 32));
+
+            alignas(32) uint64_t values[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(values), value);
+            for (size_t lane = 0; lane < 4; ++lane)
+                invalid += finish(static_cast<char>(keys[lane] & 0xFF), values[lane], ((valid >> (lane * 8)) & 0xFF) == 0xFF, aTarget[no + lane]);
+        }
+        return invalid + decode_scalar(aSource + no * aLength, aLength, aNumber - no, aTarget + no);
+    }
+
+#endif
+
+} // namespace
+
+// ----------------------------------------------------------------------
+
+bool hidb::bin::available(titer_decoder aDecoder)
+{
+    switch (aDecoder) {
+        case titer_decoder::automatic:
+        case titer_decoder::scalar:
+            return true;
+        case titer_decoder::sse2:
+#ifdef HIDB_TITER_DECODER_X86
+            return __builtin_cpu_supports("sse2");
+#else
+            return false;
+#endif
+        case titer_decoder::avx2:
+#ifdef HIDB_TITER_DECODER_X86
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+    return false;
+
+} // hidb::bin::available
+
+// ----------------------------------------------------------------------
+
+hidb::bin::titer_decoder hidb::bin::best_titer_decoder()
+{
+    static const titer_decoder best = available(titer_decoder::avx2) ? titer_decoder::avx2 : (available(titer_decoder::sse2) ? titer_decoder::sse2 : titer_decoder::scalar);
+    return best;
+
+} // hidb::bin::best_titer_decoder
+
+// ----------------------------------------------------------------------
+
+std::string_view hidb::bin::to_string(titer_decoder aDecoder)
+{
+    using namespace std::string_view_literals;
+    switch (aDecoder) {
+        case titer_decoder::automatic:
+            return "automatic"sv;
+        case titer_decoder::scalar:
+            return "scalar"sv;
+        case titer_decoder::sse2:
+            return "sse2"sv;
+        case titer_decoder::avx2:
+            return "avx2"sv;
+    }
+    return "?"sv;
+
+} // hidb::bin::to_string
+
+// ----------------------------------------------------------------------
+
+size_t hidb::bin::decode_titers(const char* aSource, size_t aMaxTiterLength, size_t aNumberOfTiters, titer_t* aTarget, titer_decoder aDecoder)
+{
+    if (aDecoder == titer_decoder::automatic)
+        aDecoder = best_titer_decoder();
+    else if (!available(aDecoder))
+        throw std::runtime_error(fmt::format("[hidb] titer decoder {} is not supported by cpu", to_string(aDecoder)));
+
+    if (aMaxTiterLength == 0) { // all titers are empty
+        std::fill(aTarget, aTarget + aNumberOfTiters, titer_t{});
+        return 0;
+    }
+
+#ifdef HIDB_TITER_DECODER_X86
+    if (aMaxTiterLength <= sizeof(uint64_t)) {
+        switch (aDecoder) {
+            case titer_decoder::avx2:
+                return decode_avx2(aSource, aMaxTiterLength, aNumberOfTiters, aTarget);
+            case titer_decoder::sse2:
+                return decode_sse2(aSource, aMaxTiterLength, aNumberOfTiters, aTarget);
+            case titer_decoder::automatic:
+            case titer_decoder::scalar:
+                break;
+        }
+    }
+#endif
+    return decode_scalar(aSource, aMaxTiterLength, aNumberOfTiters, aTarget);
+
+} // hidb::bin::decode_titers
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "hidb-5/hidb-bin.hh"
+
+// ----------------------------------------------------------------------
+
+namespace hidb::bin
+{
+    enum class titer_decoder { automatic, scalar, sse2, avx2 };
+
+      // decodes text titers of a table (aMaxTiterLength bytes per titer, zero padded, see doc/hidb5-bin-format.txt) into numeric titers
+      // aTarget must have room for aNumberOfTiters titers
+      // invalid titers are stored as dont-care, returns number of invalid titers
+      // throws std::runtime_error if aDecoder is not supported by cpu
+    size_t decode_titers(const char* aSource, size_t aMaxTiterLength, size_t aNumberOfTiters, titer_t* aTarget, titer_decoder aDecoder = titer_decoder::automatic);
+    inline size_t decode_titers(const Table& aTable, titer_t* aTarget, titer_decoder aDecoder = titer_decoder::automatic)
+    {
+        return decode_titers(aTable.titer_begin(), aTable.max_titer_length(), aTable.number_of_antigens() * aTable.number_of_sera(), aTarget, aDecoder);
+    }
+
+      // numeric titers of table aTableNo from TITR section, if aTitersSection is empty (old hidb5b), titers are decoded into aBuffer
+    inline const titer_t* titers_of_table(const Table& aTable, std::string_view aTitersSection, size_t aNumberOfTables, size_t aTableNo, std::vector<titer_t>& aBuffer)
+    {
+        if (!aTitersSection.empty())
+            return titers_of_table(aTitersSection, aNumberOfTables, aTableNo);
+        aBuffer.resize(aTable.number_of_antigens() * aTable.number_of_sera());
+        decode_titers(aTable, aBuffer.data());
+        return aBuffer.data();
+    }
+
+    bool available(titer_decoder aDecoder);
+    titer_decoder best_titer_decoder(); // the fastest decoder supported by cpu
+    std::string_view to_string(titer_decoder aDecoder);
+
+} // namespace hidb::bin
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
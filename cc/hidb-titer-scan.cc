@@ -0,0 +1,138 @@
+#include <optional>
+
+#include "hidb-5/hidb-titer-scan.hh"
+
+// ----------------------------------------------------------------------
+
+namespace
+{
+    using titer_t = hidb::bin::titer_t;
+
+      // log2(titer/10) * logged_scale, thresholded titers shifted by one step
+    inline int effective_logged(uint16_t data)
+    {
+        const int type = data >> titer_t::type_shift;
+        return static_cast<int>(data & titer_t::logged_mask) - titer_t::logged_bias - (type == titer_t::less_than) * titer_t::logged_scale + (type == titer_t::more_than) * titer_t::logged_scale;
+    }
+
+      // matches[no] = 1 if titers[no] is not dont-care and lower[no] <= effective_logged(titers[no]) <= upper[no]
+      // branchless, compiler vectorizes it
+    void scan(const titer_t* titers, size_t size, const int* lower, const int* upper, uint8_t* matches)
+    {
+        for (size_t no = 0; no < size; ++no) {
+            const uint16_t data = titers[no].data;
+            const int logged = effective_logged(data);
+            matches[no] = static_cast<uint8_t>(((data >> titer_t::type_shift) != titer_t::dont_care) & (logged >= lower[no]) & (logged <= upper[no]));
+        }
+    }
+
+      // titer of the first homologous antigen of serum found in the table
+    std::optional<int> homologous_logged(const hidb::bin::Table& table, const titer_t* titers, const hidb::bin::Serum& serum, size_t serum_no)
+    {
+        const auto [num_homologous, homologous] = serum.homologous_antigens();
+        for (const auto* antigen_index = homologous; antigen_index != homologous + num_homologous; ++antigen_index) {
+            if (const auto antigen_no = table.antigen_no(*antigen_index); antigen_no < table.number_of_antigens()) {
+                if (const auto titer = titers[antigen_no * table.number_of_sera() + serum_no]; !titer.is_dont_care())
+                    return effective_logged(titer.data);
+            }
+        }
+        return std::nullopt;
+    }
+
+} // namespace
+
+// ----------------------------------------------------------------------
+
+hidb::titer_matches_t hidb::scan_titers(const HiDb& aHiDb, AntigenIndex aAntigen, const titer_predicate_t& aPredicate)
+{
+    aHiDb.check_titers_in_index_order();
+    const auto tables = bin::tables(aHiDb.data());
+    const auto sera = bin::sera(aHiDb.data());
+    const auto titers_section = aHiDb.section(bin::section::titers);
+    const auto [num_tables, table_indexes] = bin::antigens(aHiDb.data())[*aAntigen].tables();
+
+    titer_matches_t result;
+    std::vector<titer_t> buffer;
+    std::vector<int> lower, upper;
+    std::vector<uint8_t> matches;
+    for (const auto* table_no = table_indexes; table_no != table_indexes + num_tables; ++table_no) {
+        const auto& table = tables[*table_no];
+        const auto antigen_no = table.antigen_no(static_cast<bin::antigen_index_t>(*aAntigen));
+        if (antigen_no == table.number_of_antigens())
+            continue;
+        const auto number_of_sera = table.number_of_sera();
+        const auto* titers = bin::titers_of_table(table, titers_section, tables.size(), *table_no, buffer);
+        lower.assign(number_of_sera, aPredicate.min);
+        upper.assign(number_of_sera, aPredicate.max);
+        if (aPredicate.relative == titer_predicate_t::relative_to::homologous) {
+            for (size_t serum_no = 0; serum_no < number_of_sera; ++serum_no) {
+                if (const auto homologous = homologous_logged(table, titers, sera[table.serum_begin()[serum_no]], serum_no); homologous.has_value()) {
+                    lower[serum_no] += *homologous;
+                    upper[serum_no] += *homologous;
+                }
+                else { // no homologous titer, never matches
+                    lower[serum_no] = 1;
+                    upper[serum_no] = 0;
+                }
+            }
+        }
+        matches.resize(number_of_sera);
+        const auto* row = titers + antigen_no * number_of_sera;
+        scan(row, number_of_sera, lower.data(), upper.data(), matches.data());
+        for (size_t serum_no = 0; serum_no < number_of_sera; ++serum_no) {
+            if (matches[serum_no])
+                result.push_back(titer_match_t{aAntigen, SerumIndex{table.serum_begin()[serum_no]}, TableIndex{*table_no}, row[serum_no]});
+        }
+    }
+    return result;
+
+} // hidb::scan_titers
+
+// ----------------------------------------------------------------------
+
+hidb::titer_matches_t hidb::scan_titers(const HiDb& aHiDb, SerumIndex aSerum, const titer_predicate_t& aPredicate)
+{
+    aHiDb.check_titers_in_index_order();
+    const auto tables = bin::tables(aHiDb.data());
+    const auto titers_section = aHiDb.section(bin::section::titers);
+    const auto& serum = bin::sera(aHiDb.data())[*aSerum];
+    const auto [num_tables, table_indexes] = serum.tables();
+
+    titer_matches_t result;
+    std::vector<titer_t> buffer, column;
+    std::vector<int> lower, upper;
+    std::vector<uint8_t> matches;
+    for (const auto* table_no = table_indexes; table_no != table_indexes + num_tables; ++table_no) {
+        const auto& table = tables[*table_no];
+        const auto serum_no = table.serum_no(static_cast<bin::serum_index_t>(*aSerum));
+        if (serum_no == table.number_of_sera())
+            continue;
+        const auto number_of_antigens = table.number_of_antigens(), number_of_sera = table.number_of_sera();
+        const auto* titers = bin::titers_of_table(table, titers_section, tables.size(), *table_no, buffer);
+        int shift = 0;
+        if (aPredicate.relative == titer_predicate_t::relative_to::homologous) {
+            if (const auto homologous = homologous_logged(table, titers, serum, serum_no); homologous.has_value())
+                shift = *homologous;
+            else
+                continue;
+        }
+        lower.assign(number_of_antigens, aPredicate.min + shift);
+        upper.assign(number_of_antigens, aPredicate.max + shift);
+        column.resize(number_of_antigens);
+        for (size_t antigen_no = 0; antigen_no < number_of_antigens; ++antigen_no)
+            column[antigen_no] = titers[antigen_no * number_of_sera + serum_no];
+        matches.resize(number_of_antigens);
+        scan(column.data(), number_of_antigens, lower.data(), upper.data(), matches.data());
+        for (size_t antigen_no = 0; antigen_no < number_of_antigens; ++antigen_no) {
+            if (matches[antigen_no])
+                result.push_back(titer_match_t{AntigenIndex{table.antigen_begin()[antigen_no]}, aSerum, TableIndex{*table_no}, column[antigen_no]});
+        }
+    }
+    return result;
+
+} // hidb::scan_titers
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
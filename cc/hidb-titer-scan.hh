@@ -0,0 +1,55 @@
+#pragma once
+
+#include "hidb-5/hidb.hh"
+
+// ----------------------------------------------------------------------
+
+namespace hidb
+{
+      // Titers are compared by log2(titer/10) with thresholded titers shifted by one step (<10 as 5, >1280 as 2560), dont-care titers never match
+    class titer_predicate_t
+    {
+     public:
+        static titer_predicate_t at_least(size_t aTiter) { return {relative_to::none, logged(aTiter), max_logged}; }
+        static titer_predicate_t at_most(size_t aTiter) { return {relative_to::none, min_logged, logged(aTiter)}; }
+        static titer_predicate_t between(size_t aMin, size_t aMax) { return {relative_to::none, logged(aMin), logged(aMax)}; }
+          // difference from the homologous titer (serum vs. its homologous antigen in the same table) is within aSteps log2 steps
+        static titer_predicate_t within_of_homologous(double aSteps) { const auto steps = static_cast<int>(std::lround(aSteps * bin::titer_t::logged_scale)); return {relative_to::homologous, -steps, steps}; }
+          // at least aSteps log2 steps below the homologous titer (e.g. 3 for 8-fold drop)
+        static titer_predicate_t below_homologous(double aSteps) { return {relative_to::homologous, min_logged, -static_cast<int>(std::lround(aSteps * bin::titer_t::logged_scale))}; }
+
+        enum class relative_to { none, homologous };
+
+        relative_to relative;
+        int min; // bin::titer_t::logged_raw() units, relative to the homologous titer for relative_to::homologous
+        int max;
+
+     private:
+        constexpr static const int min_logged = -1'000'000;
+        constexpr static const int max_logged = 1'000'000;
+        static int logged(size_t aTiter) { return bin::titer_t::from_value(bin::titer_t::regular, aTiter).logged_raw(); }
+
+        titer_predicate_t(relative_to aRelative, int aMin, int aMax) : relative{aRelative}, min{aMin}, max{aMax} {}
+
+    }; // class titer_predicate_t
+
+    struct titer_match_t
+    {
+        AntigenIndex antigen;
+        SerumIndex serum;
+        TableIndex table;
+        bin::titer_t titer;
+    };
+
+    using titer_matches_t = std::vector<titer_match_t>; // sorted by table, then by serum (antigen)
+
+      // titers of aAntigen against all sera (of aSerum against all antigens) in all tables of aAntigen (aSerum) satisfying aPredicate
+    titer_matches_t scan_titers(const HiDb& aHiDb, AntigenIndex aAntigen, const titer_predicate_t& aPredicate);
+    titer_matches_t scan_titers(const HiDb& aHiDb, SerumIndex aSerum, const titer_predicate_t& aPredicate);
+
+} // namespace hidb
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
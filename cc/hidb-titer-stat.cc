@@ -0,0 +1,156 @@
+#include <unordered_map>
+#include <algorithm>
+
+#include "hidb-5/hidb-titer-stat.hh"
+#include "hidb-5/hidb-parallel.hh"
+
+// ----------------------------------------------------------------------
+
+namespace
+{
+    struct pair_key_t
+    {
+        uint32_t antigen;
+        uint32_t serum;
+        uint32_t group;
+
+        bool operator==(const pair_key_t& rhs) const { return antigen == rhs.antigen && serum == rhs.serum && group == rhs.group; }
+    };
+
+    struct pair_key_hash_t
+    {
+        size_t operator()(const pair_key_t& key) const { return std::hash<uint64_t>{}((static_cast<uint64_t>(key.antigen) << 32 | key.serum) ^ (key.group * 0x9E3779B97F4A7C15ULL)); }
+    };
+
+    struct accumulator_t
+    {
+        double sum = 0.0;
+        size_t count = 0;
+        hidb::bin::titer_t min;
+        hidb::bin::titer_t max;
+
+        void add(hidb::bin::titer_t titer)
+        {
+            const auto logged = titer.logged_with_thresholded();
+            if (count == 0 || logged < min.logged_with_thresholded())
+                min = titer;
+            if (count == 0 || logged > max.logged_with_thresholded())
+                max = titer;
+            sum += logged;
+            ++count;
+        }
+
+        void merge(const accumulator_t& other)
+        {
+            if (other.count == 0)
+                return;
+            if (count == 0 || other.min.logged_with_thresholded() < min.logged_with_thresholded())
+                min = other.min;
+            if (count == 0 || other.max.logged_with_thresholded() > max.logged_with_thresholded())
+                max = other.max;
+            sum += other.sum;
+            count += other.count;
+        }
+    };
+
+    using accumulators_t = std::unordered_map<pair_key_t, accumulator_t, pair_key_hash_t>;
+
+} // namespace
+
+// ----------------------------------------------------------------------
+
+hidb::titer_stats_t hidb::titer_stats(const HiDb& aHiDb, titer_stat_split aSplit, size_t aThreads)
+{
+    aHiDb.check_titers_in_index_order();
+    const auto tables = bin::tables(aHiDb.data());
+    const auto titers_section = aHiDb.section(bin::section::titers);
+    const size_t number_of_antigens = bin::antigens(aHiDb.data()).size();
+
+    titer_stats_t result;
+    std::vector<uint32_t> group_of_table(tables.size(), 0);
+    switch (aSplit) {
+        case titer_stat_split::none:
+            result.groups.push_back(titer_stat_group_t{});
+            break;
+        case titer_stat_split::lab_assay_rbc:
+            if (const auto& strings = aHiDb.strings(); !strings.empty()) {
+                  // string ids (version 2): group by integer ids
+                std::vector<bin::TableStringIds> group_ids;
+                for (size_t table_no = 0; table_no < tables.size(); ++table_no) {
+                    const auto& ids = tables[table_no].string_ids();
+                    auto found = std::find_if(group_ids.begin(), group_ids.end(), [&ids](const auto& gr) { return gr.lab == ids.lab && gr.assay == ids.assay && gr.rbc == ids.rbc; });
+                    if (found == group_ids.end()) {
+                        found = group_ids.insert(found, ids);
+                        result.groups.push_back(titer_stat_group_t{strings[ids.lab], strings[ids.assay], strings[ids.rbc]});
+                    }
+                    group_of_table[table_no] = static_cast<uint32_t>(found - group_ids.begin());
+                }
+            }
+            else {
+                for (size_t table_no = 0; table_no < tables.size(); ++table_no) {
+                    const auto& table = tables[table_no];
+                    const titer_stat_group_t group{table.lab(strings), table.assay(strings), table.rbc(strings)};
+                    auto found = std::find_if(result.groups.begin(), result.groups.end(), [&group](const auto& gr) { return gr.lab == group.lab && gr.assay == group.assay && gr.rbc == group.rbc; });
+                    if (found == result.groups.end())
+                        found = result.groups.insert(found, group);
+                    group_of_table[table_no] = static_cast<uint32_t>(found - result.groups.begin());
+                }
+            }
+            break;
+    }
+
+      // each thread accumulates its tables into partitions by antigen index range, partitions are merged in parallel afterwards
+    const auto threads = number_of_threads(aThreads, tables.size());
+    const auto partitions = threads;
+    const auto partition_of = [partitions, number_of_antigens](size_t antigen_index) { return antigen_index * partitions / number_of_antigens; };
+    std::vector<std::vector<accumulators_t>> per_thread(threads, std::vector<accumulators_t>(partitions));
+    parallel_chunks(tables.size(), threads, [&](size_t thread_no, size_t first, size_t last) {
+        std::vector<bin::titer_t> buffer;
+        auto& accumulators = per_thread[thread_no];
+        for (size_t table_no = first; table_no < last; ++table_no) {
+            const auto& table = tables[table_no];
+            const auto* titer = bin::titers_of_table(table, titers_section, tables.size(), table_no, buffer);
+            for (const auto* antigen = table.antigen_begin(); antigen != table.antigen_end(); ++antigen) {
+                auto& partition = accumulators[partition_of(*antigen)];
+                for (const auto* serum = table.serum_begin(); serum != table.serum_end(); ++serum, ++titer) {
+                    if (!titer->is_dont_care())
+                        partition[pair_key_t{*antigen, *serum, group_of_table[table_no]}].add(*titer);
+                }
+            }
+        }
+    });
+
+    std::vector<std::vector<titer_stat_t>> merged(partitions);
+    parallel_chunks(partitions, threads, [&](size_t /*thread_no*/, size_t first, size_t last) {
+        for (size_t partition_no = first; partition_no < last; ++partition_no) {
+            auto& target = per_thread[0][partition_no];
+            for (size_t thread_no = 1; thread_no < threads; ++thread_no) {
+                for (const auto& [key, accumulator] : per_thread[thread_no][partition_no])
+                    target[key].merge(accumulator);
+                per_thread[thread_no][partition_no] = accumulators_t{};
+            }
+            auto& stats = merged[partition_no];
+            stats.reserve(target.size());
+            for (const auto& [key, accumulator] : target)
+                stats.push_back(titer_stat_t{AntigenIndex{key.antigen}, SerumIndex{key.serum}, key.group, accumulator.count, accumulator.sum / static_cast<double>(accumulator.count), accumulator.min, accumulator.max});
+            std::sort(stats.begin(), stats.end(), [](const auto& e1, const auto& e2) {
+                if (e1.antigen != e2.antigen)
+                    return e1.antigen < e2.antigen;
+                if (e1.serum != e2.serum)
+                    return e1.serum < e2.serum;
+                return e1.group < e2.group;
+            });
+            target = accumulators_t{};
+        }
+    });
+
+    for (const auto& stats : merged)
+        result.stats.insert(result.stats.end(), stats.begin(), stats.end());
+    return result;
+
+} // hidb::titer_stats
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "hidb-5/hidb.hh"
+
+// ----------------------------------------------------------------------
+
+namespace hidb
+{
+    enum class titer_stat_split { none, lab_assay_rbc };
+
+    struct titer_stat_group_t
+    {
+        std::string_view lab;
+        std::string_view assay;
+        std::string_view rbc;
+    };
+
+    struct titer_stat_t
+    {
+        AntigenIndex antigen;
+        SerumIndex serum;
+        size_t group; // index in titer_stats_t::groups, always 0 for titer_stat_split::none
+        size_t number_of_titers; // dont-care titers are ignored
+        double logged_mean; // mean of log2(titer/10), <10 counts as 5, >1280 as 2560
+        bin::titer_t min;
+        bin::titer_t max;
+
+        double geometric_mean() const { return 10.0 * std::exp2(logged_mean); }
+    };
+
+    struct titer_stats_t
+    {
+        std::vector<titer_stat_group_t> groups; // single group with empty fields for titer_stat_split::none
+        std::vector<titer_stat_t> stats;        // sorted by antigen, serum, group
+    };
+
+      // geometric mean, count, min and max titer of each antigen/serum pair over all tables where both are present
+      // aThreads == 0: number of cpus
+    titer_stats_t titer_stats(const HiDb& aHiDb, titer_stat_split aSplit = titer_stat_split::none, size_t aThreads = 0);
+
+} // namespace hidb
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
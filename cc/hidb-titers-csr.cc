@@ -0,0 +1,215 @@
+#include <cstring>
+#include <tuple>
+#include <utility>
+#include <algorithm>
+
+#include "acmacs-base/fmt.hh"
+#include "hidb-5/hidb-titers-csr.hh"
+#include "hidb-5/hidb-parallel.hh"
+
+// ----------------------------------------------------------------------
+
+static inline size_t sera_offset(size_t aNumberOfAntigens) { return sizeof(hidb::TitersCSR::Header) + sizeof(uint64_t) * (aNumberOfAntigens + 1); }
+static inline size_t tables_offset(size_t aNumberOfAntigens, size_t aNumberOfTiters) { return sera_offset(aNumberOfAntigens) + sizeof(hidb::bin::serum_index_t) * aNumberOfTiters; }
+static inline size_t titers_offset(size_t aNumberOfAntigens, size_t aNumberOfTiters) { return tables_offset(aNumberOfAntigens, aNumberOfTiters) + sizeof(hidb::bin::table_index_t) * aNumberOfTiters; }
+static inline size_t data_size(size_t aNumberOfAntigens, size_t aNumberOfTiters) { return titers_offset(aNumberOfAntigens, aNumberOfTiters) + sizeof(hidb::bin::titer_t) * aNumberOfTiters; }
+
+static hidb::TableIndexList all_tables(const hidb::HiDb& aHiDb);
+
+// ----------------------------------------------------------------------
+
+std::string hidb::TitersCSR::signature()
+{
+    return "HIDB5CSR";
+
+} // hidb::TitersCSR::signature
+
+// ----------------------------------------------------------------------
+
+hidb::TitersCSR::TitersCSR(const HiDb& aHiDb, size_t aThreads)
+    : TitersCSR(aHiDb, all_tables(aHiDb), aThreads)
+{
+} // hidb::TitersCSR::TitersCSR
+
+// ----------------------------------------------------------------------
+
+hidb::TitersCSR::TitersCSR(std::string_view aFilename, const HiDb& aHiDb)
+{
+    acmacs::file::read_access access(aFilename);
+    const auto sig = signature();
+    if (access.size() < sizeof(Header) || std::memcmp(access.data(), sig.data(), sig.size()) != 0)
+        throw std::runtime_error(fmt::format("[hidb] not a titers csr file: {}", aFilename));
+    mAccess = std::move(access);
+    mData = mAccess.data();
+    if (mAccess.size() < data_size(number_of_antigens(), number_of_titers()))
+        throw std::runtime_error(fmt::format("[hidb] truncated titers csr file: {}", aFilename));
+    if (virus_type() != aHiDb.virus_type() || header().source != aHiDb.fingerprint())
+        throw std::runtime_error(fmt::format("[hidb] titers csr file {} was made from another hidb (virus type: {}), re-make it with hidb5-titers-csr", aFilename, virus_type()));
+
+} // hidb::TitersCSR::TitersCSR
+
+// ----------------------------------------------------------------------
+
+hidb::TitersCSR::TitersCSR(const HiDb& aHiDb, const TableIndexList& aTables, size_t aThreads)
+{
+    TableIndexList table_indexes{aTables};
+    std::sort(table_indexes.begin(), table_indexes.end());
+    table_indexes.erase(std::unique(table_indexes.begin(), table_indexes.end()), table_indexes.end());
+
+    auto hidb_tables = aHiDb.tables(); // HiDb::tables() is not thread safe, Tables::at() is
+    const size_t number_of_antigens = aHiDb.antigens()->size();
+    const auto threads = number_of_threads(aThreads, table_indexes.size());
+
+      // 1. decode titers of each table, count titers of each antigen in each thread
+    std::vector<std::vector<bin::titer_t>> titers_of_table(table_indexes.size());
+    std::vector<AntigenIndexList> antigens_of_table(table_indexes.size());
+    std::vector<SerumIndexList> sera_of_table(table_indexes.size());
+    std::vector<std::vector<uint32_t>> per_thread(threads, std::vector<uint32_t>(number_of_antigens, 0));
+    parallel_chunks(table_indexes.size(), threads, [&](size_t thread_no, size_t first, size_t last) {
+        auto& counts = per_thread[thread_no];
+        for (size_t no = first; no < last; ++no) {
+            const auto table = hidb_tables->at(table_indexes[no]);
+            titers_of_table[no] = table->titers();
+            antigens_of_table[no] = table->antigens();
+            sera_of_table[no] = table->sera();
+            const auto number_of_sera = sera_of_table[no].size();
+            for (size_t ag_no = 0; ag_no < antigens_of_table[no].size(); ++ag_no) {
+                const auto* row = titers_of_table[no].data() + ag_no * number_of_sera;
+                counts[*antigens_of_table[no][ag_no]] += static_cast<uint32_t>(std::count_if(row, row + number_of_sera, [](bin::titer_t titer) { return !titer.is_dont_care(); }));
+            }
+        }
+    });
+
+      // 2. row offsets, per_thread becomes position of the first titer of each thread relative to the row start
+    std::vector<uint64_t> row_offsets(number_of_antigens + 1, 0);
+    for (size_t ag_no = 0; ag_no < number_of_antigens; ++ag_no) {
+        uint32_t in_row = 0;
+        for (auto& counts : per_thread)
+            in_row += std::exchange(counts[ag_no], in_row);
+        row_offsets[ag_no + 1] = row_offsets[ag_no] + in_row;
+    }
+    const auto number_of_titers = row_offsets.back();
+
+    mDataStorage.resize(data_size(number_of_antigens, number_of_titers), 0);
+    mData = mDataStorage.data();
+    auto* header = reinterpret_cast<Header*>(mDataStorage.data());
+    const auto sig = signature();
+    std::memmove(header->signature, sig.data(), sig.size());
+    const auto virus_type = aHiDb.virus_type();
+    header->virus_type_size = static_cast<uint8_t>(std::min(virus_type.size(), sizeof(header->virus_type_)));
+    std::memmove(header->virus_type_, virus_type.data(), header->virus_type_size);
+    header->number_of_antigens = static_cast<uint32_t>(number_of_antigens);
+    header->number_of_sera = static_cast<uint32_t>(aHiDb.sera()->size());
+    header->number_of_tables = static_cast<uint32_t>(*hidb_tables->size());
+    header->number_of_titers = number_of_titers;
+    header->source = aHiDb.fingerprint();
+    std::memmove(mDataStorage.data() + sizeof(Header), row_offsets.data(), sizeof(uint64_t) * row_offsets.size());
+
+      // 3. fill rows, each thread writes its tables into its own slots, within a row titers are ordered by table
+    auto* target_sera = reinterpret_cast<bin::serum_index_t*>(mDataStorage.data() + sera_offset(number_of_antigens));
+    auto* target_tables = reinterpret_cast<bin::table_index_t*>(mDataStorage.data() + tables_offset(number_of_antigens, number_of_titers));
+    auto* target_titers = reinterpret_cast<bin::titer_t*>(mDataStorage.data() + titers_offset(number_of_antigens, number_of_titers));
+    parallel_chunks(table_indexes.size(), threads, [&](size_t thread_no, size_t first, size_t last) {
+        auto& cursors = per_thread[thread_no];
+        for (size_t no = first; no < last; ++no) {
+            const auto& antigens = antigens_of_table[no];
+            const auto& sera = sera_of_table[no];
+            const auto* titer = titers_of_table[no].data();
+            for (const auto antigen_index : antigens) {
+                for (const auto serum_index : sera) {
+                    if (!titer->is_dont_care()) {
+                        const auto pos = row_offsets[*antigen_index] + cursors[*antigen_index]++;
+                        target_sera[pos] = static_cast<bin::serum_index_t>(*serum_index);
+                        target_tables[pos] = static_cast<bin::table_index_t>(*table_indexes[no]);
+                        target_titers[pos] = *titer;
+                    }
+                    ++titer;
+                }
+            }
+            titers_of_table[no] = std::vector<bin::titer_t>{};
+        }
+    });
+
+      // 4. sort each row by serum, then by table
+    parallel_chunks(number_of_antigens, threads, [&](size_t /*thread_no*/, size_t first, size_t last) {
+        std::vector<std::tuple<bin::serum_index_t, bin::table_index_t, bin::titer_t>> row;
+        for (size_t ag_no = first; ag_no < last; ++ag_no) {
+            row.clear();
+            for (auto pos = row_offsets[ag_no]; pos < row_offsets[ag_no + 1]; ++pos)
+                row.emplace_back(target_sera[pos], target_tables[pos], target_titers[pos]);
+            std::stable_sort(row.begin(), row.end(), [](const auto& e1, const auto& e2) { return std::get<0>(e1) < std::get<0>(e2); });
+            auto pos = row_offsets[ag_no];
+            for (const auto& [serum_index, table_index, titer] : row) {
+                target_sera[pos] = serum_index;
+                target_tables[pos] = table_index;
+                target_titers[pos] = titer;
+                ++pos;
+            }
+        }
+    });
+
+} // hidb::TitersCSR::TitersCSR
+
+// ----------------------------------------------------------------------
+
+std::string_view hidb::TitersCSR::virus_type() const
+{
+    return {header().virus_type_, header().virus_type_size};
+
+} // hidb::TitersCSR::virus_type
+
+// ----------------------------------------------------------------------
+
+const uint64_t* hidb::TitersCSR::row_offsets() const
+{
+    return reinterpret_cast<const uint64_t*>(mData + sizeof(Header));
+
+} // hidb::TitersCSR::row_offsets
+
+// ----------------------------------------------------------------------
+
+const hidb::bin::serum_index_t* hidb::TitersCSR::sera() const
+{
+    return reinterpret_cast<const bin::serum_index_t*>(mData + sera_offset(number_of_antigens()));
+
+} // hidb::TitersCSR::sera
+
+// ----------------------------------------------------------------------
+
+const hidb::bin::table_index_t* hidb::TitersCSR::tables() const
+{
+    return reinterpret_cast<const bin::table_index_t*>(mData + tables_offset(number_of_antigens(), number_of_titers()));
+
+} // hidb::TitersCSR::tables
+
+// ----------------------------------------------------------------------
+
+const hidb::bin::titer_t* hidb::TitersCSR::titers() const
+{
+    return reinterpret_cast<const bin::titer_t*>(mData + titers_offset(number_of_antigens(), number_of_titers()));
+
+} // hidb::TitersCSR::titers
+
+// ----------------------------------------------------------------------
+
+void hidb::TitersCSR::save(std::string_view aFilename) const
+{
+    acmacs::file::write(aFilename, std::string_view{mData, data_size(number_of_antigens(), number_of_titers())});
+
+} // hidb::TitersCSR::save
+
+// ----------------------------------------------------------------------
+
+hidb::TableIndexList all_tables(const hidb::HiDb& aHiDb)
+{
+    hidb::TableIndexList result(*aHiDb.tables()->size());
+    for (size_t no = 0; no < result.size(); ++no)
+        result[no] = hidb::TableIndex{no};
+    return result;
+
+} // all_tables
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "hidb-5/hidb.hh"
+
+// ----------------------------------------------------------------------
+
+namespace hidb
+{
+      // All titers of a hidb (or of some of its tables) in compressed sparse row form (see doc/hidb5-bin-format.txt)
+      // rows are hidb antigen indexes, each row lists (serum index, table index, titer) sorted by serum then table
+      // dont-care titers are not stored
+    class TitersCSR
+    {
+     public:
+        TitersCSR(const HiDb& aHiDb, size_t aThreads = 0); // all tables, aThreads == 0: number of cpus
+        TitersCSR(const HiDb& aHiDb, const TableIndexList& aTables, size_t aThreads = 0);
+        TitersCSR(std::string_view aFilename, const HiDb& aHiDb); // reads file written by save(), uncompressed file is memory mapped, throws if file was made from another hidb
+
+        std::string_view virus_type() const;
+        size_t number_of_antigens() const { return header().number_of_antigens; }
+        size_t number_of_sera() const { return header().number_of_sera; }
+        size_t number_of_tables() const { return header().number_of_tables; } // in hidb, table indexes below refer to hidb tables
+        size_t number_of_titers() const { return header().number_of_titers; }
+
+        const uint64_t* row_offsets() const; // number_of_antigens() + 1 offsets into sera(), tables(), titers()
+        const bin::serum_index_t* sera() const;
+        const bin::table_index_t* tables() const;
+        const bin::titer_t* titers() const;
+
+        std::pair<size_t, size_t> row(AntigenIndex aAntigen) const { return {row_offsets()[*aAntigen], row_offsets()[*aAntigen + 1]}; } // [first, last) in sera(), tables(), titers()
+
+        void save(std::string_view aFilename) const;
+
+        struct Header
+        {
+            char signature[8];
+            uint8_t virus_type_size;
+            char virus_type_[7];
+            uint32_t number_of_antigens;
+            uint32_t number_of_sera;
+            uint32_t number_of_tables;
+            uint32_t _padding1;
+            uint64_t number_of_titers;
+            bin::Fingerprint source; // of hidb5b the file was made from
+        };
+
+        static std::string signature();
+
+     private:
+        const char* mData = nullptr;
+        std::string mDataStorage;
+        acmacs::file::read_access mAccess;
+
+        const Header& header() const { return *reinterpret_cast<const Header*>(mData); }
+
+    }; // class TitersCSR
+
+} // namespace hidb
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
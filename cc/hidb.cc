@@ -1,15 +1,19 @@
 #include <algorithm>
+#include <numeric>
 #include <optional>
+#include <limits>
+#include <cstring>
+#include <cstdlib>
 
 #include "acmacs-base/log.hh"
 #include "acmacs-base/fmt.hh"
 #include "acmacs-base/string.hh"
 #include "acmacs-base/string-split.hh"
 #include "acmacs-base/string-join.hh"
-#include "acmacs-virus/virus-name-v1.hh"
 #include "hidb-5/hidb.hh"
 #include "hidb-5/hidb-bin.hh"
 #include "hidb-5/hidb-json.hh"
+#include "hidb-5/hidb-bitmap.hh"
 
 // ----------------------------------------------------------------------
 
@@ -19,22 +23,36 @@ hidb::HiDb::HiDb(std::string_view aFilename, bool verbose)
     if (hidb::bin::has_signature(access.data())) {
         mAccess = std::move(access);
         mData = mAccess.data();
+        mSections = hidb::bin::sections(mData, mAccess.size());
     }
     else if (std::string data = access; data.find("\"  version\": \"hidb-v5\"") != std::string::npos) {
-        mDataStorage = hidb::json::read(data, verbose);
-        mData = mDataStorage.data();
+        const auto converted = hidb::json::read(data, verbose);
+        constexpr size_t cache_line = 64;
+        mDataStorageSize = converted.size();
+        mDataStorage.reset(static_cast<char*>(std::aligned_alloc(cache_line, (mDataStorageSize + cache_line - 1) / cache_line * cache_line)));
+        if (!mDataStorage)
+            throw std::bad_alloc{};
+        std::memcpy(mDataStorage.get(), converted.data(), mDataStorageSize);
+        mData = mDataStorage.get();
+        mSections = hidb::bin::sections(mData, mDataStorageSize);
     }
     else
         throw std::runtime_error(fmt::format("[hidb] unrecognized file: {}", aFilename));
 
+    if (format_version() >= bin::format_version_string_ids) {
+        mStrings = bin::Strings{section(bin::section::strings)};
+        if (mStrings.empty())
+            throw error{fmt::format("[hidb] no string dictionary (STRS section) in {}", aFilename)};
+    }
+
 } // hidb::HiDb::HiDb
 
 // ----------------------------------------------------------------------
 
 void hidb::HiDb::save(std::string_view aFilename) const
 {
-    if (!mDataStorage.empty())
-        acmacs::file::write(aFilename, mDataStorage);
+    if (mDataStorage)
+        acmacs::file::write(aFilename, {mDataStorage.get(), mDataStorageSize});
     else if (mAccess.valid())
         acmacs::file::write(aFilename, {mAccess.data(), mAccess.size()});
 
@@ -44,12 +62,15 @@ void hidb::HiDb::save(std::string_view aFilename) const
 
 std::shared_ptr<hidb::Antigens> hidb::HiDb::antigens() const
 {
-    const auto* antigens = mData + reinterpret_cast<const hidb::bin::Header*>(mData)->antigen_offset;
-    const auto number_of_antigens = *reinterpret_cast<const hidb::bin::ast_number_t*>(antigens);
-    return std::make_shared<hidb::Antigens>(static_cast<size_t>(number_of_antigens),
-                                            antigens + sizeof(hidb::bin::ast_number_t),
-                                            antigens + sizeof(hidb::bin::ast_number_t) + sizeof(hidb::bin::ast_offset_t) * (number_of_antigens + 1),
-                                            *this);
+    std::call_once(antigens_made_, [this]() {
+        const auto* antigens = mData + reinterpret_cast<const hidb::bin::Header*>(mData)->antigen_offset;
+        const auto number_of_antigens = *reinterpret_cast<const hidb::bin::ast_number_t*>(antigens);
+        antigens_ = std::make_shared<hidb::Antigens>(static_cast<size_t>(number_of_antigens),
+                                                     antigens + sizeof(hidb::bin::ast_number_t),
+                                                     antigens + sizeof(hidb::bin::ast_number_t) + sizeof(hidb::bin::ast_offset_t) * (number_of_antigens + 1),
+                                                     *this);
+    });
+    return antigens_;
 
 } // hidb::HiDb::antigens
 
@@ -63,13 +84,63 @@ std::string_view hidb::HiDb::virus_type() const
 
 // ----------------------------------------------------------------------
 
+uint32_t hidb::HiDb::format_version() const
+{
+    if (const auto data = section(bin::section::format_version); data.size() >= sizeof(bin::FormatVersion))
+        return reinterpret_cast<const bin::FormatVersion*>(data.data())->version;
+    else
+        return 0;
+
+} // hidb::HiDb::format_version
+
+// ----------------------------------------------------------------------
+
+uint32_t hidb::HiDb::format_flags() const
+{
+    if (const auto data = section(bin::section::format_version); data.size() >= sizeof(bin::FormatVersion))
+        return reinterpret_cast<const bin::FormatVersion*>(data.data())->flags;
+    else
+        return 0;
+
+} // hidb::HiDb::format_flags
+
+// ----------------------------------------------------------------------
+
+void hidb::titers_not_in_index_order()
+{
+    throw error{"[hidb] titers of this hidb5b are in the order of the source charts (made from hidb5.json made by an older hidb5-make), they cannot be read, re-make hidb5.json and hidb5b"};
+
+} // hidb::titers_not_in_index_order
+
+// ----------------------------------------------------------------------
+
+std::string_view hidb::HiDb::section(bin::section_id_t aId) const
+{
+    if (mSections) {
+        if (const auto* found = std::find_if(mSections->begin(), mSections->end(), [aId](const auto& entry) { return entry.id == aId; }); found != mSections->end())
+            return {mData + found->offset, found->size};
+    }
+    return {};
+
+} // hidb::HiDb::section
+
+// ----------------------------------------------------------------------
+
 hidb::AntigenP hidb::Antigens::at(AntigenIndex aIndex) const
 {
-    return std::make_shared<hidb::Antigen>(mAntigen0 + reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex)[*aIndex], mHiDb);
+    return std::make_shared<hidb::Antigen>(AntigenRef{*reinterpret_cast<const hidb::bin::Antigen*>(mAntigen0 + reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex)[*aIndex]), aIndex, mHiDb.ast_context()});
 }
 
 // ----------------------------------------------------------------------
 
+hidb::AntigenP hidb::Antigens::make(const hidb::bin::Antigen* antigen_bin) const
+{
+    return std::make_shared<hidb::Antigen>(AntigenRef{*antigen_bin, index(antigen_bin), mHiDb.ast_context()});
+
+} // hidb::Antigens::make
+
+// ----------------------------------------------------------------------
+
 hidb::AntigenIndex hidb::Antigens::index(const hidb::bin::Antigen* antigen_bin) const
 {
     const auto antigen_record_offset = static_cast<hidb::bin::ast_offset_t>(reinterpret_cast<const char*>(antigen_bin) - mAntigen0);
@@ -94,11 +165,7 @@ hidb::AntigenPList hidb::Antigens::list(const AntigenIndexList& indexes) const
 
 acmacs::virus::name_t hidb::Antigen::name() const
 {
-    auto antigen = reinterpret_cast<const hidb::bin::Antigen*>(mAntigen);
-    if (antigen->cdc_name())
-        return acmacs::virus::name_t{antigen->name()};
-    else
-        return acmacs::virus::name_t{std::string(mHiDb.virus_type()) + "/" + antigen->name()};
+    return acmacs::virus::name_t{mRef.name()};
 
 } // hidb::Antigen::name
 
@@ -106,7 +173,7 @@ acmacs::virus::name_t hidb::Antigen::name() const
 
 std::string_view hidb::Antigen::location() const
 {
-    return reinterpret_cast<const hidb::bin::Antigen*>(mAntigen)->location();
+    return mRef.location();
 
 } // hidb::Antigen::location
 
@@ -114,7 +181,7 @@ std::string_view hidb::Antigen::location() const
 
 std::string_view hidb::Antigen::isolation() const
 {
-    return reinterpret_cast<const hidb::bin::Antigen*>(mAntigen)->isolation();
+    return mRef.isolation();
 
 } // hidb::Antigen::isolation
 
@@ -122,7 +189,7 @@ std::string_view hidb::Antigen::isolation() const
 
 std::string hidb::Antigen::year() const
 {
-    return reinterpret_cast<const hidb::bin::Antigen*>(mAntigen)->year();
+    return mRef.year();
 
 } // hidb::Antigen::year
 
@@ -130,7 +197,7 @@ std::string hidb::Antigen::year() const
 
 acmacs::chart::Date hidb::Antigen::date() const
 {
-    return acmacs::chart::Date{reinterpret_cast<const hidb::bin::Antigen*>(mAntigen)->date(false)};
+    return acmacs::chart::Date{mRef.date()};
 
 } // hidb::Antigen::date
 
@@ -138,7 +205,7 @@ acmacs::chart::Date hidb::Antigen::date() const
 
 std::string hidb::Antigen::date_compact() const
 {
-    return reinterpret_cast<const hidb::bin::Antigen*>(mAntigen)->date(true);
+    return mRef.date_compact();
 
 } // hidb::Antigen::date_compact
 
@@ -146,7 +213,7 @@ std::string hidb::Antigen::date_compact() const
 
 acmacs::virus::Passage hidb::Antigen::passage() const
 {
-    return acmacs::virus::Passage{reinterpret_cast<const hidb::bin::Antigen*>(mAntigen)->passage()};
+    return acmacs::virus::Passage{mRef.passage()};
 
 } // hidb::Antigen::passage
 
@@ -154,7 +221,7 @@ acmacs::virus::Passage hidb::Antigen::passage() const
 
 acmacs::chart::BLineage hidb::Antigen::lineage() const
 {
-    return reinterpret_cast<const hidb::bin::Antigen*>(mAntigen)->lineage;
+    return mRef.lineage();
 
 } // hidb::Antigen::lineage
 
@@ -162,7 +229,7 @@ acmacs::chart::BLineage hidb::Antigen::lineage() const
 
 acmacs::virus::Reassortant hidb::Antigen::reassortant() const
 {
-    return acmacs::virus::Reassortant{reinterpret_cast<const hidb::bin::Antigen*>(mAntigen)->reassortant()};
+    return acmacs::virus::Reassortant{mRef.reassortant()};
 
 } // hidb::Antigen::reassortant
 
@@ -170,7 +237,7 @@ acmacs::virus::Reassortant hidb::Antigen::reassortant() const
 
 acmacs::chart::LabIds hidb::Antigen::lab_ids() const
 {
-    const auto lab_ids = reinterpret_cast<const hidb::bin::Antigen*>(mAntigen)->lab_ids();
+    const auto lab_ids = mRef.lab_ids();
     acmacs::chart::LabIds result(lab_ids.size());
     std::transform(lab_ids.begin(), lab_ids.end(), result.begin(), [](const auto& li) { return std::string(li); });
     return result;
@@ -179,22 +246,29 @@ acmacs::chart::LabIds hidb::Antigen::lab_ids() const
 
 // ----------------------------------------------------------------------
 
-acmacs::chart::Annotations hidb::Antigen::annotations() const
+static inline acmacs::chart::Annotations make_annotations(const std::vector<std::string_view>& aAnnotations)
 {
-    const auto annotations = reinterpret_cast<const hidb::bin::Antigen*>(mAntigen)->annotations();
-    acmacs::chart::Annotations result(annotations.size());
-    std::transform(annotations.begin(), annotations.end(), result.begin(), [](const auto& anno) { return std::string(anno); });
+    acmacs::chart::Annotations result(aAnnotations.size());
+    std::transform(aAnnotations.begin(), aAnnotations.end(), result.begin(), [](const auto& anno) { return std::string(anno); });
     return result;
 
+} // make_annotations
+
+// ----------------------------------------------------------------------
+
+acmacs::chart::Annotations hidb::Antigen::annotations() const
+{
+    return make_annotations(mRef.annotations());
+
 } // hidb::Antigen::annotations
 
 // ----------------------------------------------------------------------
 
 hidb::TableIndexList hidb::Antigen::tables() const
 {
-    const auto [size, ptr] = reinterpret_cast<const hidb::bin::Antigen*>(mAntigen)->tables();
-    TableIndexList result(size);
-    std::transform(ptr, ptr + size, result.begin(), [](const auto& index) { return TableIndex{index}; });
+    const auto tables = mRef.tables();
+    TableIndexList result(tables.size());
+    std::transform(tables.begin(), tables.end(), result.begin(), [](const auto& index) { return TableIndex{index}; });
     return result;
 
 } // hidb::Antigen::tables
@@ -203,16 +277,15 @@ hidb::TableIndexList hidb::Antigen::tables() const
 
 size_t hidb::Antigen::number_of_tables() const
 {
-    return reinterpret_cast<const hidb::bin::Antigen*>(mAntigen)->tables().first;
+    return mRef.number_of_tables();
 
 } // hidb::Antigen::number_of_tables
 
 // ----------------------------------------------------------------------
 
-std::string_view hidb::Antigen::country(const LocDb& locdb) const noexcept
+static std::string_view country_of_location(std::string_view loc, const LocDb& locdb) noexcept
 {
     using namespace std::string_view_literals;
-    const auto loc = location();
     if (const auto country = locdb.country(loc); !country.empty())
         return country;
     else if (loc.size() == 2) {
@@ -226,13 +299,29 @@ std::string_view hidb::Antigen::country(const LocDb& locdb) const noexcept
     else
         return "UNKNOWN"sv;
 
+} // country_of_location
+
+// ----------------------------------------------------------------------
+
+std::string_view hidb::Antigen::country(const LocDb& locdb) const noexcept
+{
+    return mRef.country(locdb);
+
 } // hidb::Antigen::country
 
 // ----------------------------------------------------------------------
 
+std::string_view hidb::AntigenRef::country(const LocDb& locdb) const noexcept
+{
+    return country_of_location(location(), locdb);
+
+} // hidb::AntigenRef::country
+
+// ----------------------------------------------------------------------
+
 std::string hidb::Antigen::full_name() const
 {
-    return acmacs::string::join(acmacs::string::join_space, name(), acmacs::string::join(acmacs::string::join_space, annotations()), reassortant(), passage());
+    return mRef.full_name();
 
 } // hidb::Antigen::full_name
 
@@ -253,15 +342,35 @@ std::shared_ptr<hidb::Sera> hidb::HiDb::sera() const
 
 hidb::SerumP hidb::Sera::at(SerumIndex aIndex) const
 {
-    return std::make_shared<hidb::Serum>(mSerum0 + reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex)[*aIndex], mHiDb);
+    return std::make_shared<hidb::Serum>(SerumRef{*reinterpret_cast<const hidb::bin::Serum*>(mSerum0 + reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex)[*aIndex]), aIndex, mHiDb.ast_context()});
 
 } // hidb::Sera::at
 
 // ----------------------------------------------------------------------
 
+hidb::SerumP hidb::Sera::make(const hidb::bin::Serum* serum_bin) const
+{
+    return std::make_shared<hidb::Serum>(SerumRef{*serum_bin, index(serum_bin), mHiDb.ast_context()});
+
+} // hidb::Sera::make
+
+// ----------------------------------------------------------------------
+
+hidb::SerumIndex hidb::Sera::index(const hidb::bin::Serum* serum_bin) const
+{
+    const auto serum_record_offset = static_cast<hidb::bin::ast_offset_t>(reinterpret_cast<const char*>(serum_bin) - mSerum0);
+    const auto* index = reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex);
+    if (const auto* ind_p = std::lower_bound(index, index + mNumberOfSera, serum_record_offset); ind_p != (index + mNumberOfSera) && *ind_p == serum_record_offset)
+        return SerumIndex{ind_p - index};
+    throw std::runtime_error{fmt::format("internal error in hidb::Sera::index: serum record offset {} not found", serum_record_offset)};
+
+} // hidb::Sera::index
+
+// ----------------------------------------------------------------------
+
 acmacs::virus::name_t hidb::Serum::name() const
 {
-    return acmacs::virus::name_t{std::string(mHiDb.virus_type()) + "/" + reinterpret_cast<const hidb::bin::Serum*>(mSerum)->name()};
+    return acmacs::virus::name_t{mRef.name()};
 
 } // hidb::Serum::name
 
@@ -269,7 +378,7 @@ acmacs::virus::name_t hidb::Serum::name() const
 
 acmacs::virus::name_t hidb::Serum::name_without_subtype() const
 {
-    return acmacs::virus::name_t{reinterpret_cast<const hidb::bin::Serum*>(mSerum)->name()};
+    return acmacs::virus::name_t{mRef.name_without_virus_type()};
 
 } // hidb::Serum::name_without_subtype
 
@@ -277,7 +386,7 @@ acmacs::virus::name_t hidb::Serum::name_without_subtype() const
 
 acmacs::virus::Passage hidb::Serum::passage() const
 {
-    return acmacs::virus::Passage{reinterpret_cast<const hidb::bin::Serum*>(mSerum)->passage()};
+    return acmacs::virus::Passage{mRef.passage()};
 
 } // hidb::Serum::passsre
 
@@ -285,7 +394,7 @@ acmacs::virus::Passage hidb::Serum::passage() const
 
 acmacs::chart::BLineage hidb::Serum::lineage() const
 {
-    return reinterpret_cast<const hidb::bin::Serum*>(mSerum)->lineage;
+    return mRef.lineage();
 
 } // hidb::Serum::lineage
 
@@ -293,7 +402,7 @@ acmacs::chart::BLineage hidb::Serum::lineage() const
 
 acmacs::virus::Reassortant hidb::Serum::reassortant() const
 {
-    return acmacs::virus::Reassortant{reinterpret_cast<const hidb::bin::Serum*>(mSerum)->reassortant()};
+    return acmacs::virus::Reassortant{mRef.reassortant()};
 
 } // hidb::Serum::reassortant
 
@@ -301,10 +410,7 @@ acmacs::virus::Reassortant hidb::Serum::reassortant() const
 
 acmacs::chart::Annotations hidb::Serum::annotations() const
 {
-    const auto annotations = reinterpret_cast<const hidb::bin::Serum*>(mSerum)->annotations();
-    acmacs::chart::Annotations result(annotations.size());
-    std::transform(annotations.begin(), annotations.end(), result.begin(), [](const auto& anno) { return std::string(anno); });
-    return result;
+    return make_annotations(mRef.annotations());
 
 } // hidb::Serum::annotations
 
@@ -312,7 +418,7 @@ acmacs::chart::Annotations hidb::Serum::annotations() const
 
 acmacs::chart::SerumId hidb::Serum::serum_id() const
 {
-    return acmacs::chart::SerumId{reinterpret_cast<const hidb::bin::Serum*>(mSerum)->serum_id()};
+    return acmacs::chart::SerumId{mRef.serum_id()};
 
 } // hidb::Serum::serum_id
 
@@ -320,7 +426,7 @@ acmacs::chart::SerumId hidb::Serum::serum_id() const
 
 acmacs::chart::SerumSpecies hidb::Serum::serum_species() const
 {
-    return acmacs::chart::SerumSpecies{reinterpret_cast<const hidb::bin::Serum*>(mSerum)->serum_species()};
+    return acmacs::chart::SerumSpecies{mRef.serum_species()};
 
 } // hidb::Serum::serum_species
 
@@ -328,9 +434,9 @@ acmacs::chart::SerumSpecies hidb::Serum::serum_species() const
 
 acmacs::chart::PointIndexList hidb::Serum::homologous_antigens() const
 {
-    const auto [size, ptr] = reinterpret_cast<const hidb::bin::Serum*>(mSerum)->homologous_antigens();
-    acmacs::chart::PointIndexList result(size);
-    std::transform(ptr, ptr + size, result.begin(), [](const auto& index) -> size_t { return static_cast<size_t>(index); });
+    const auto homologous = mRef.homologous_antigens();
+    acmacs::chart::PointIndexList result(homologous.size());
+    std::transform(homologous.begin(), homologous.end(), result.begin(), [](const auto& index) -> size_t { return static_cast<size_t>(index); });
     return result;
 
 } // hidb::Serum::homologous_antigens
@@ -339,9 +445,9 @@ acmacs::chart::PointIndexList hidb::Serum::homologous_antigens() const
 
 hidb::TableIndexList hidb::Serum::tables() const
 {
-    const auto [size, ptr] = reinterpret_cast<const hidb::bin::Serum*>(mSerum)->tables();
-    TableIndexList result(size);
-    std::transform(ptr, ptr + size, result.begin(), [](const auto& index) { return TableIndex{index}; });
+    const auto tables = mRef.tables();
+    TableIndexList result(tables.size());
+    std::transform(tables.begin(), tables.end(), result.begin(), [](const auto& index) { return TableIndex{index}; });
     return result;
 
 } // hidb::Serum::tables
@@ -350,7 +456,7 @@ hidb::TableIndexList hidb::Serum::tables() const
 
 size_t hidb::Serum::number_of_tables() const
 {
-    return reinterpret_cast<const hidb::bin::Serum*>(mSerum)->tables().first;
+    return mRef.number_of_tables();
 
 } // hidb::Serum::number_of_tables
 
@@ -358,7 +464,7 @@ size_t hidb::Serum::number_of_tables() const
 
 std::string_view hidb::Serum::location() const
 {
-    return reinterpret_cast<const hidb::bin::Serum*>(mSerum)->location();
+    return mRef.location();
 
 } // hidb::Serum::location
 
@@ -366,7 +472,7 @@ std::string_view hidb::Serum::location() const
 
 std::string_view hidb::Serum::isolation() const
 {
-    return reinterpret_cast<const hidb::bin::Serum*>(mSerum)->isolation();
+    return mRef.isolation();
 
 } // hidb::Serum::isolation
 
@@ -374,7 +480,7 @@ std::string_view hidb::Serum::isolation() const
 
 std::string hidb::Serum::year() const
 {
-    return reinterpret_cast<const hidb::bin::Serum*>(mSerum)->year();
+    return mRef.year();
 
 } // hidb::Serum::year
 
@@ -396,29 +502,52 @@ std::vector<std::string> hidb::Serum::labs(const Tables& all_tables) const
 
 std::string hidb::Serum::full_name() const
 {
-    return acmacs::string::join(acmacs::string::join_space, name(), acmacs::string::join(acmacs::string::join_space, annotations()), reassortant(), serum_id());
+    return mRef.full_name();
 
 } // hidb::Serum::full_name
 
 // ----------------------------------------------------------------------
 
+hidb::TableRefs hidb::HiDb::table_refs() const
+{
+    const auto tables = bin::tables(mData);
+    return {tables, TableRef::context_t{tables.size(), section(bin::section::titers), section(bin::section::table_dates), titers_in_index_order(), &mStrings}};
+
+} // hidb::HiDb::table_refs
+
+// ----------------------------------------------------------------------
+
 std::shared_ptr<hidb::Tables> hidb::HiDb::tables() const
 {
-    if (!tables_) {
+    std::call_once(tables_made_, [this]() {
         const auto* tables = mData + reinterpret_cast<const hidb::bin::Header*>(mData)->table_offset;
         const auto number_of_tables = *reinterpret_cast<const hidb::bin::ast_number_t*>(tables);
         tables_ = std::make_shared<hidb::Tables>(TableIndex{number_of_tables}, tables + sizeof(hidb::bin::ast_number_t),
-                                                 tables + sizeof(hidb::bin::ast_number_t) + sizeof(hidb::bin::ast_offset_t) * (number_of_tables + 1));
-    }
+                                                 tables + sizeof(hidb::bin::ast_number_t) + sizeof(hidb::bin::ast_offset_t) * (number_of_tables + 1), mStrings,
+                                                 section(hidb::bin::section::titers), section(hidb::bin::section::table_summaries),
+                                                 section(hidb::bin::section::table_dates), section(hidb::bin::section::tables_by_date), section(hidb::bin::section::reference_antigens),
+                                                 section(hidb::bin::section::table_groups), mData, titers_in_index_order());
+    });
     return tables_;
 
 } // hidb::HiDb::tables
 
 // ----------------------------------------------------------------------
 
+std::shared_ptr<hidb::BitmapIndex> hidb::HiDb::bitmaps() const
+{
+    std::call_once(bitmaps_made_, [this]() { bitmaps_ = std::make_shared<BitmapIndex>(*this); });
+    return bitmaps_;
+
+} // hidb::HiDb::bitmaps
+
+// ----------------------------------------------------------------------
+
 std::shared_ptr<hidb::Table> hidb::Tables::at(TableIndex aIndex) const
 {
-    return std::make_shared<hidb::Table>(mTable0 + reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex)[*aIndex]);
+    const auto* record = reinterpret_cast<const hidb::bin::Table*>(mTable0 + reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex)[*aIndex]);
+    const auto* summary = mSummaries.empty() ? nullptr : reinterpret_cast<const hidb::bin::TableSummary*>(mSummaries.data()) + *aIndex;
+    return std::make_shared<hidb::Table>(TableRef{*record, aIndex, TableRef::context_t{*mNumberOfTables, mTiters, mDates, mTitersInIndexOrder, mStrings}}, summary);
 
 } // hidb::Tables::at
 
@@ -426,32 +555,12 @@ std::shared_ptr<hidb::Table> hidb::Tables::at(TableIndex aIndex) const
 
 std::vector<hidb::lab_assay_rbc_table_t> hidb::Tables::sorted(const TableIndexList& indexes, lab_assay_rbc_table_t::sort_by_date_order order) const
 {
-    std::vector<std::shared_ptr<Table>> tables_of_indexes(indexes.size());
-    std::transform(std::begin(indexes), std::end(indexes), tables_of_indexes.begin(), [this](auto aIndex) { return at(aIndex); });
-
-    std::sort(std::begin(tables_of_indexes), std::end(tables_of_indexes), [order](const auto& t1, const auto& t2) {
-        const auto k1 = fmt::format("{}:{}:{}", t1->lab(), t1->assay(), t1->rbc()), k2 = fmt::format("{}:{}:{}", t2->lab(), t2->assay(), t2->rbc());
-        if (k1 == k2) {
-            switch (order) {
-                case lab_assay_rbc_table_t::oldest_first:
-                    return t1->date() < t2->date();
-                case lab_assay_rbc_table_t::recent_first:
-                    return t1->date() > t2->date();
-            }
-            return t1->date() < t2->date(); // g++-10
-        }
-        else
-            return k1 < k2;
-    });
-
+      // a group is a distinct lab, assay and rbc, strings are not compared
     std::vector<hidb::lab_assay_rbc_table_t> by_lab;
-    for (const auto& table : tables_of_indexes) {
-        const acmacs::chart::Assay assay{table->assay()};
-        const acmacs::chart::RbcSpecies rbc{table->rbc()};
-        if (by_lab.empty() || by_lab.back().lab != table->lab() || by_lab.back().assay != assay || by_lab.back().rbc != rbc)
-            by_lab.emplace_back(table->lab(), assay, rbc, table);
-        else
-            by_lab.back().tables.push_back(table);
+    for (const auto& group : grouped(indexes, order)) {
+        auto& entry = by_lab.emplace_back(group.lab, acmacs::chart::Assay{group.assay}, acmacs::chart::RbcSpecies{group.rbc}, at(group.tables.front()));
+        for (auto table_index = std::next(group.tables.begin()); table_index != group.tables.end(); ++table_index)
+            entry.tables.push_back(at(*table_index));
     }
     return by_lab;
 
@@ -459,9 +568,55 @@ std::vector<hidb::lab_assay_rbc_table_t> hidb::Tables::sorted(const TableIndexLi
 
 // ----------------------------------------------------------------------
 
+hidb::bin::TableGroups hidb::Tables::groups() const
+{
+    if (!mGroups.empty())
+        return bin::TableGroups{mGroups};
+
+    std::call_once(mGroupsStorageMade, [this]() { mGroupsStorage = bin::table_groups_section(mData, *mStrings); });
+    return bin::TableGroups{mGroupsStorage};
+
+} // hidb::Tables::groups
+
+// ----------------------------------------------------------------------
+
+std::vector<hidb::table_group_t> hidb::Tables::grouped(const TableIndexList& aTables, lab_assay_rbc_table_t::sort_by_date_order aOrder) const
+{
+    const auto table_groups = groups();
+    struct entry_t
+    {
+        uint32_t group;
+        bin::TableDate date;
+        TableIndex table;
+    };
+    std::vector<entry_t> entries(aTables.size());
+    std::transform(std::begin(aTables), std::end(aTables), entries.begin(), [this, &table_groups](auto aIndex) { return entry_t{table_groups.of(*aIndex), date(aIndex), aIndex}; });
+    std::sort(std::begin(entries), std::end(entries), [aOrder](const auto& e1, const auto& e2) {
+        if (e1.group != e2.group)
+            return e1.group < e2.group;
+        if (e1.date != e2.date)
+            return aOrder == lab_assay_rbc_table_t::recent_first ? e1.date > e2.date : e1.date < e2.date;
+        return e1.table < e2.table;
+    });
+
+    const auto tables = bin::tables(mData);
+    std::vector<table_group_t> result;
+    for (const auto& entry : entries) {
+        if (result.empty() || result.back().group != entry.group) {
+            const auto& first = tables[table_groups.first_table(entry.group)];
+            result.push_back(table_group_t{entry.group, first.lab(*mStrings), first.assay(*mStrings), first.rbc(*mStrings), {}});
+        }
+        result.back().tables.push_back(entry.table);
+    }
+    return result;
+
+} // hidb::Tables::grouped
+
+// ----------------------------------------------------------------------
+
 std::string hidb::Table::name() const
 {
-    return acmacs::string::join(acmacs::string::join_colon, lab(), assay(), acmacs::chart::BLineage{mTable->lineage}.to_string(), rbc(), date());
+    return mRef.name();
 
 } // hidb::Table::name
 
@@ -469,7 +624,7 @@ std::string hidb::Table::name() const
 
 std::string_view hidb::Table::assay() const
 {
-    return mTable->assay();
+    return mRef.assay();
 
 } // hidb::Table::assay
 
@@ -477,7 +632,7 @@ std::string_view hidb::Table::assay() const
 
 std::string_view hidb::Table::lab() const
 {
-    return mTable->lab();
+    return mRef.lab();
 
 } // hidb::Table::lab
 
@@ -485,7 +640,7 @@ std::string_view hidb::Table::lab() const
 
 std::string_view hidb::Table::date() const
 {
-    return mTable->date();
+    return mRef.date();
 
 } // hidb::Table::date
 
@@ -493,7 +648,7 @@ std::string_view hidb::Table::date() const
 
 std::string_view hidb::Table::rbc() const
 {
-    return mTable->rbc();
+    return mRef.rbc();
 
 } // hidb::Table::rbc
 
@@ -501,7 +656,7 @@ std::string_view hidb::Table::rbc() const
 
 size_t hidb::Table::number_of_antigens() const
 {
-    return mTable->number_of_antigens();
+    return mRef.number_of_antigens();
 
 } // hidb::Table::number_of_antigens
 
@@ -509,7 +664,7 @@ size_t hidb::Table::number_of_antigens() const
 
 size_t hidb::Table::number_of_sera() const
 {
-    return mTable->number_of_sera();
+    return mRef.number_of_sera();
 
 } // hidb::Table::number_of_sera
 
@@ -517,7 +672,8 @@ size_t hidb::Table::number_of_sera() const
 
 hidb::AntigenIndexList hidb::Table::antigens() const
 {
-    return AntigenIndexList{mTable->antigen_begin(), mTable->antigen_end()};
+    const auto antigens = mRef.antigens();
+    return AntigenIndexList{antigens.begin(), antigens.end()};
 
 } // hidb::Table::antigens
 
@@ -525,7 +681,8 @@ hidb::AntigenIndexList hidb::Table::antigens() const
 
 hidb::SerumIndexList hidb::Table::sera() const
 {
-    return SerumIndexList{mTable->serum_begin(), mTable->serum_end()};
+    const auto sera = mRef.sera();
+    return SerumIndexList{sera.begin(), sera.end()};
 
 } // hidb::Table::sera
 
@@ -533,41 +690,123 @@ hidb::SerumIndexList hidb::Table::sera() const
 
 hidb::AntigenIndexList hidb::Table::reference_antigens(const HiDb& aHidb) const
 {
-      // antigens with names (without annotations and reassortant) that match serum name (without annotations and reassortant) in the same table are reference
-      // there is minor possibility that test antigen with the same name present, it becomes false positive
-    auto sera = aHidb.sera();
-    std::vector<std::string> serum_names(mTable->number_of_sera());
-    std::transform(mTable->serum_begin(), mTable->serum_end(), serum_names.begin(),
-                   [&sera](size_t serum_index) -> std::string {
-                       auto serum = sera->at(SerumIndex{serum_index});
-                       return *serum->name();
-                         // return string::join(acmacs::string::join_space, {serum->name(), string::join(acmacs::string::join_space, serum->annotations()), serum->reassortant()});
-                   });
-      // AD_DEBUG("sera: {}", serum_names);
+    const auto [number_of, antigen_indexes] = aHidb.tables()->reference_antigens(mRef.index());
+    AntigenIndexList result(number_of);
+    std::transform(antigen_indexes, antigen_indexes + number_of, result.begin(), [](bin::antigen_index_t index) { return AntigenIndex{index}; });
+    return result;
 
-    AntigenIndexList result;
-    auto antigens = aHidb.antigens();
-    for (const auto* antigen_index = mTable->antigen_begin(); antigen_index != mTable->antigen_end(); ++antigen_index) {
-        auto antigen = antigens->at(AntigenIndex{*antigen_index});
-        const auto antigen_name = antigen->name();
-          // const auto antigen_name = string::join(acmacs::string::join_space, {antigen->name(), string::join(acmacs::string::join_space, antigen->annotations()), antigen->reassortant()});
-        if (std::find(serum_names.begin(), serum_names.end(), *antigen_name) != serum_names.end())
-            result.push_back(AntigenIndex{*antigen_index});
+} // hidb::Table::reference_antigens
+
+// ----------------------------------------------------------------------
+
+acmacs::chart::Titer hidb::Table::titer(size_t aAntigenNo, size_t aSerumNo) const
+{
+    return acmacs::chart::Titer{std::string{mRef.titer_text(aAntigenNo, aSerumNo)}};
+
+} // hidb::Table::titer
+
+// ----------------------------------------------------------------------
+
+std::string_view hidb::Table::titer_text(size_t aAntigenNo, size_t aSerumNo) const
+{
+    return mRef.titer_text(aAntigenNo, aSerumNo);
+
+} // hidb::Table::titer_text
+
+// ----------------------------------------------------------------------
+
+hidb::bin::titer_t hidb::Table::titer_numeric(size_t aAntigenNo, size_t aSerumNo) const
+{
+    return mRef.titer_numeric(aAntigenNo, aSerumNo);
+
+} // hidb::Table::titer_numeric
+
+// ----------------------------------------------------------------------
+
+std::string hidb::TableRef::name() const
+{
+    return acmacs::string::join(acmacs::string::join_colon, lab(), assay(), acmacs::chart::BLineage{mRecord->lineage}.to_string(), rbc(), date());
+
+} // hidb::TableRef::name
+
+// ----------------------------------------------------------------------
+
+hidb::bin::titer_t hidb::TableRef::titer_numeric(size_t aAntigenNo, size_t aSerumNo) const
+{
+    check_titers_in_index_order();
+    if (mTiters)
+        return mTiters[aAntigenNo * mRecord->number_of_sera() + aSerumNo];
+    try {
+        return hidb::bin::titer_t::make(mRecord->titer(aAntigenNo, aSerumNo));
+    }
+    catch (hidb::bin::invalid_titer&) {
+        return hidb::bin::titer_t{};
     }
+
+} // hidb::TableRef::titer_numeric
+
+// ----------------------------------------------------------------------
+
+std::vector<hidb::bin::titer_t> hidb::Table::titers_of_antigen(size_t aAntigenNo) const
+{
+    const auto number_of_sera = mRef.number_of_sera();
+    if (const auto* titers = mRef.numeric_titers(); titers)
+        return std::vector<bin::titer_t>(titers + aAntigenNo * number_of_sera, titers + (aAntigenNo + 1) * number_of_sera);
+    std::vector<bin::titer_t> result(number_of_sera);
+    const auto length = mRef.record().max_titer_length();
+    bin::decode_titers(mRef.record().titer_begin() + aAntigenNo * number_of_sera * length, length, number_of_sera, result.data());
     return result;
 
-} // hidb::Table::reference_antigens
+} // hidb::Table::titers_of_antigen
+
+// ----------------------------------------------------------------------
+
+std::vector<hidb::bin::titer_t> hidb::Table::titers_of_serum(size_t aSerumNo) const
+{
+    std::vector<bin::titer_t> result(mRef.number_of_antigens());
+    for (size_t ag_no = 0; ag_no < result.size(); ++ag_no)
+        result[ag_no] = titer_numeric(ag_no, aSerumNo);
+    return result;
+
+} // hidb::Table::titers_of_serum
+
+// ----------------------------------------------------------------------
+
+std::vector<hidb::bin::titer_t> hidb::Table::titers() const
+{
+    const auto number_of_titers = mRef.number_of_antigens() * mRef.number_of_sera();
+    if (const auto* titers = mRef.numeric_titers(); titers)
+        return std::vector<bin::titer_t>(titers, titers + number_of_titers);
+    return decode_titers(bin::titer_decoder::automatic);
+
+} // hidb::Table::titers
+
+// ----------------------------------------------------------------------
+
+std::vector<hidb::bin::titer_t> hidb::Table::decode_titers(bin::titer_decoder aDecoder) const
+{
+    std::vector<bin::titer_t> result(mRef.number_of_antigens() * mRef.number_of_sera());
+    bin::decode_titers(mRef.record(), result.data(), aDecoder);
+    return result;
+
+} // hidb::Table::decode_titers
+
+// ----------------------------------------------------------------------
+
+hidb::bin::TableSummary hidb::Table::summary() const
+{
+    if (mSummary)
+        return *mSummary;
+    const auto all_titers = decode_titers(bin::titer_decoder::automatic); // summary does not depend on the order of titers
+    return bin::TableSummary::make(all_titers.data(), all_titers.size());
+
+} // hidb::Table::summary
 
 // ----------------------------------------------------------------------
 
 std::shared_ptr<hidb::Table> hidb::Tables::most_recent(const TableIndexList& aTables) const
 {
-    const auto* index = reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex);
-    auto table_date_compare = [this, index](TableIndex i1, TableIndex i2) -> bool {
-        const auto t1{reinterpret_cast<const bin::Table*>(this->mTable0 + index[*i1])}, t2{reinterpret_cast<const bin::Table*>(this->mTable0 + index[*i2])};
-        return t1->date() < t2->date();
-    };
-    return operator[](*std::max_element(aTables.begin(), aTables.end(), table_date_compare));
+    return operator[](*std::max_element(aTables.begin(), aTables.end(), [this](TableIndex i1, TableIndex i2) { return date(i1) < date(i2); }));
 
 } // hidb::Tables::most_recent
 
@@ -575,32 +814,95 @@ std::shared_ptr<hidb::Table> hidb::Tables::most_recent(const TableIndexList& aTa
 
 std::shared_ptr<hidb::Table> hidb::Tables::oldest(const TableIndexList& aTables) const
 {
-    const auto* index = reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex);
-    auto table_date_compare = [this, index](TableIndex i1, TableIndex i2) -> bool {
-        const auto t1{reinterpret_cast<const bin::Table*>(this->mTable0 + index[*i1])}, t2{reinterpret_cast<const bin::Table*>(this->mTable0 + index[*i2])};
-        return t1->date() < t2->date();
-    };
-    return operator[](*std::min_element(aTables.begin(), aTables.end(), table_date_compare));
+    return operator[](*std::min_element(aTables.begin(), aTables.end(), [this](TableIndex i1, TableIndex i2) { return date(i1) < date(i2); }));
 
 } // hidb::Tables::oldest
 
 // ----------------------------------------------------------------------
 
+hidb::bin::TableDate hidb::Tables::date(TableIndex aIndex) const
+{
+    if (!mDates.empty())
+        return reinterpret_cast<const bin::TableDate*>(mDates.data())[*aIndex];
+    return bin::TableDate::make(reinterpret_cast<const bin::Table*>(mTable0 + reinterpret_cast<const bin::ast_offset_t*>(mIndex)[*aIndex])->date());
+
+} // hidb::Tables::date
+
+// ----------------------------------------------------------------------
+
+std::pair<const hidb::bin::DatedTable*, const hidb::bin::DatedTable*> hidb::Tables::by_date(bin::TableDate aFirst, bin::TableDate aAfterLast) const
+{
+    const bin::DatedTable *begin, *end;
+    if (!mByDate.empty()) {
+        begin = reinterpret_cast<const bin::DatedTable*>(mByDate.data());
+        end = begin + mByDate.size() / sizeof(bin::DatedTable);
+    }
+    else {
+        std::call_once(mByDateStorageMade, [this]() {
+            for (size_t table_no = 0; table_no < *mNumberOfTables; ++table_no)
+                mByDateStorage.push_back(bin::DatedTable{date(TableIndex{table_no}), static_cast<bin::table_index_t>(table_no)});
+            std::sort(mByDateStorage.begin(), mByDateStorage.end(), [](const auto& e1, const auto& e2) { return e1.date == e2.date ? e1.table < e2.table : e1.date < e2.date; });
+        });
+        begin = mByDateStorage.data();
+        end = begin + mByDateStorage.size();
+    }
+    const auto less_than = [](const bin::DatedTable& entry, bin::TableDate look_for) { return entry.date < look_for; };
+    const auto* first = std::lower_bound(begin, end, aFirst, less_than);
+    return {first, std::lower_bound(first, end, aAfterLast, less_than)};
+
+} // hidb::Tables::by_date
+
+// ----------------------------------------------------------------------
+
+std::pair<size_t, const hidb::bin::antigen_index_t*> hidb::Tables::reference_antigens(TableIndex aIndex) const
+{
+    if (!mReferenceAntigens.empty())
+        return bin::reference_antigens(mReferenceAntigens, *mNumberOfTables, *aIndex);
+
+    std::call_once(mReferenceAntigensStorageMade, [this]() { mReferenceAntigensStorage = bin::reference_antigens_section(mData, *mStrings); });
+    return bin::reference_antigens(mReferenceAntigensStorage, *mNumberOfTables, *aIndex);
+
+} // hidb::Tables::reference_antigens
+
+// ----------------------------------------------------------------------
+
+hidb::TableIndex hidb::Tables::index(const Table& aTable) const
+{
+    return aTable.ref().index();
+
+} // hidb::Tables::index
+
+// ----------------------------------------------------------------------
+
 std::vector<hidb::TableStat> hidb::Tables::stat(const TableIndexList& tables) const
 {
     std::vector<hidb::TableStat> result;
+    std::vector<std::pair<bin::TableDate, bin::TableDate>> most_recent_oldest; // dates of result entries
+      // tables are matched to entries by their lab/assay/rbc group, not by comparing strings
+    const auto table_groups = groups();
+    constexpr const size_t no_entry = std::numeric_limits<size_t>::max();
+    std::vector<size_t> entry_of_group(table_groups.size(), no_entry);
     for (auto table_no : tables) {
         auto table = operator[](table_no);
-        const auto assay = table->assay(), lab = table->lab(), rbc = table->rbc();
-        if (auto found = std::find_if(std::begin(result), std::end(result), [assay, lab, rbc](const auto& entry) { return assay == entry.assay && lab == entry.lab && rbc == entry.rbc; }); found != std::end(result)) {
+        const auto table_date = date(table_no);
+        if (auto& entry_no = entry_of_group[table_groups.of(*table_no)]; entry_no != no_entry) {
+            auto found = result.begin() + static_cast<std::ptrdiff_t>(entry_no);
             ++found->number;
-            if (table->date() > found->most_recent->date())
+            auto& [most_recent, oldest] = most_recent_oldest[entry_no];
+            if (table_date > most_recent) {
                 found->most_recent = table;
-            else if (table->date() < found->oldest->date())
+                most_recent = table_date;
+            }
+            else if (table_date < oldest) {
                 found->oldest = table;
+                oldest = table_date;
+            }
+        }
+        else {
+            entry_no = result.size();
+            result.emplace_back(table->assay(), table->lab(), table->rbc(), table);
+            most_recent_oldest.emplace_back(table_date, table_date);
         }
-        else
-            result.emplace_back(assay, lab, rbc, table);
     }
     return result;
 
@@ -627,6 +929,75 @@ std::string hidb::TableStat::title() const noexcept
 
 // ----------------------------------------------------------------------
 
+hidb::table_titers_t hidb::HiDb::titers(AntigenIndex aAntigen, SerumIndex aSerum) const
+{
+    const auto bin_tables = hidb::bin::tables(mData);
+    const auto refs = table_refs();
+    const auto [ag_num_tables, ag_tables] = hidb::bin::antigens(mData)[*aAntigen].tables();
+    const auto [sr_num_tables, sr_tables] = hidb::bin::sera(mData)[*aSerum].tables();
+
+      // table lists of antigens and sera are sorted
+    table_titers_t result;
+    for (auto ag_table = ag_tables, sr_table = sr_tables; ag_table != ag_tables + ag_num_tables && sr_table != sr_tables + sr_num_tables;) {
+        if (*ag_table < *sr_table)
+            ++ag_table;
+        else if (*sr_table < *ag_table)
+            ++sr_table;
+        else {
+            const auto& table = bin_tables[*ag_table];
+            const auto row = table.antigen_no(static_cast<hidb::bin::antigen_index_t>(*aAntigen));
+            const auto column = table.serum_no(static_cast<hidb::bin::serum_index_t>(*aSerum));
+            if (row < table.number_of_antigens() && column < table.number_of_sera())
+                result.push_back({TableIndex{*ag_table}, table.date(), refs[TableIndex{*ag_table}].titer_numeric(row, column)});
+            ++ag_table;
+            ++sr_table;
+        }
+    }
+    return result;
+
+} // hidb::HiDb::titers
+
+// ----------------------------------------------------------------------
+
+std::vector<hidb::table_titers_t> hidb::HiDb::titers(const AntigenIndexList& aAntigens, const SerumIndexList& aSera) const
+{
+    const auto bin_tables = hidb::bin::tables(mData);
+    const auto refs = table_refs();
+
+      // rows of the requested antigens in each table: (antigen no in aAntigens, row)
+    std::vector<std::vector<std::pair<size_t, size_t>>> rows(bin_tables.size());
+    const auto bin_antigens = hidb::bin::antigens(mData);
+    for (size_t ag_no = 0; ag_no < aAntigens.size(); ++ag_no) {
+        const auto [num_tables, ag_tables] = bin_antigens[*aAntigens[ag_no]].tables();
+        for (const auto* table_no = ag_tables; table_no != ag_tables + num_tables; ++table_no) {
+            const auto& table = bin_tables[*table_no];
+            if (const auto row = table.antigen_no(static_cast<hidb::bin::antigen_index_t>(*aAntigens[ag_no])); row < table.number_of_antigens())
+                rows[*table_no].emplace_back(ag_no, row);
+        }
+    }
+
+      // tables of each serum are visited in order, result for each pair is therefore sorted by table index
+    std::vector<table_titers_t> result(aAntigens.size() * aSera.size());
+    const auto bin_sera = hidb::bin::sera(mData);
+    for (size_t sr_no = 0; sr_no < aSera.size(); ++sr_no) {
+        const auto [num_tables, sr_tables] = bin_sera[*aSera[sr_no]].tables();
+        for (const auto* table_no = sr_tables; table_no != sr_tables + num_tables; ++table_no) {
+            if (const auto& table_rows = rows[*table_no]; !table_rows.empty()) {
+                const auto& table = bin_tables[*table_no];
+                if (const auto column = table.serum_no(static_cast<hidb::bin::serum_index_t>(*aSera[sr_no])); column < table.number_of_sera()) {
+                    const auto titers_of_table = refs[TableIndex{*table_no}];
+                    for (const auto& [ag_no, row] : table_rows)
+                        result[ag_no * aSera.size() + sr_no].push_back({TableIndex{*table_no}, table.date(), titers_of_table.titer_numeric(row, column)});
+                }
+            }
+        }
+    }
+    return result;
+
+} // hidb::HiDb::titers
+
+// ----------------------------------------------------------------------
+
 using offset_t = const hidb::bin::ast_offset_t*;
 
 struct first_last_t
@@ -643,29 +1014,70 @@ struct first_last_t
 
 }; // struct first_last_t
 
-template <typename F> inline first_last_t filter_by(first_last_t first_last, F field, std::string_view look_for)
+  // name keys and location tree sections (see doc/hidb5-bin-format.txt) for the offsets of antigens (sera) index
+struct name_index_t
+{
+    name_index_t(const hidb::HiDb& aHiDb, hidb::bin::section_id_t aKeysId, hidb::bin::section_id_t aTreeId, offset_t aIndexBegin)
+        : keys{aHiDb.section(aKeysId).empty() ? nullptr : reinterpret_cast<const hidb::bin::NameKey*>(aHiDb.section(aKeysId).data())}, tree{aHiDb.section(aTreeId)}, index_begin{aIndexBegin}, strings{aHiDb.strings()} {}
+    const hidb::bin::NameKey& operator[](offset_t offset) const { return keys[offset - index_begin]; }
+    const hidb::bin::NameKey* keys; // nullptr if section is absent
+    const hidb::bin::LocationTree tree;
+    offset_t index_begin;
+    const hidb::bin::Strings& strings; // see HiDb::strings()
+
+}; // struct name_index_t
+
+  // aCompare(offset_t) is three-way comparison of a record field with the value looked for, records are sorted by that field within first_last
+template <typename F> inline first_last_t filter_by(first_last_t first_last, F aCompare)
 {
-    const auto found = std::lower_bound(
-        first_last.first, first_last.last, look_for,
-        [field](hidb::bin::ast_offset_t offset, const std::string_view& look_for_2) -> bool { return field(offset) < look_for_2; });
+    const auto found = std::partition_point(first_last.first, first_last.last, [&aCompare](const hidb::bin::ast_offset_t& offset) { return aCompare(&offset) < 0; });
     for (auto end = found; end != first_last.last; ++end) {
-        if (field(*end) != look_for)
+        if (aCompare(end) != 0)
             return {found, end};
     }
     return {found, first_last.last};
 }
 
-template <typename AgSr, typename S> inline first_last_t find_by(first_last_t first_last, const char* aData, S location, S isolation, S year, hidb::find_fuzzy fuzzy)
+  // three-way comparison of a field (aField().substr(0, aSize)) with aLookFor using the field prefix stored in the name key,
+  // aField() (i.e. the full record) is accessed only if the prefix is truncated and the comparison is not decided by it
+template <size_t W, typename F> inline int compare_by_prefix(const char (&aPrefix)[W], std::string_view aLookFor, F aField, size_t aSize = std::string_view::npos)
+{
+    const std::string_view full_prefix{aPrefix, ::strnlen(aPrefix, W)};
+    const auto prefix = full_prefix.substr(0, aSize);
+    if (full_prefix.size() < W || aSize <= W)
+        return prefix.compare(aLookFor);
+    if (const auto cmp = prefix.compare(aLookFor.substr(0, W)); cmp != 0)
+        return cmp;
+    return aField().substr(0, aSize).compare(aLookFor);
+}
+
+template <typename AgSr> inline first_last_t find_by(first_last_t first_last, const char* aData, const name_index_t& keys, std::string_view location, std::string_view isolation, std::string_view year, hidb::find_fuzzy fuzzy)
 {
-    first_last = filter_by(first_last, [aData](hidb::bin::ast_offset_t offset) { return reinterpret_cast<const AgSr*>(aData + offset)->location(); }, location);
+    const auto record = [aData](offset_t offset) { return reinterpret_cast<const AgSr*>(aData + *offset); };
+    if (!keys.tree.empty()) { // the first stage (first_last is the whole index): records having location prefix
+        const auto [first, last] = keys.tree.find(location);
+        first_last = first_last_t{keys.index_begin + first, keys.index_begin + last};
+    }
+    first_last = filter_by(first_last, [&](offset_t offset) {
+        return keys.keys ? compare_by_prefix(keys[offset].location, location, [&] { return record(offset)->location(keys.strings); }) : record(offset)->location(keys.strings).compare(location);
+    });
     if (!isolation.empty()) {
         const auto first_last_saved = first_last;
-        first_last = filter_by(first_last, [aData](hidb::bin::ast_offset_t offset) { return reinterpret_cast<const AgSr*>(aData + offset)->isolation(); }, isolation);
-        if (first_last.empty() && fuzzy == hidb::find_fuzzy::yes) // try isolation as prefix
-            first_last = filter_by(first_last_saved, [aData,size=isolation.size()](hidb::bin::ast_offset_t offset) { return reinterpret_cast<const AgSr*>(aData + offset)->isolation().substr(0, size); }, isolation);
+        first_last = filter_by(first_last, [&](offset_t offset) {
+            return keys.keys ? compare_by_prefix(keys[offset].isolation, isolation, [&] { return record(offset)->isolation(); }) : record(offset)->isolation().compare(isolation);
+        });
+        if (first_last.empty() && fuzzy == hidb::find_fuzzy::yes) { // try isolation as prefix
+            first_last = filter_by(first_last_saved, [&](offset_t offset) {
+                return keys.keys ? compare_by_prefix(keys[offset].isolation, isolation, [&] { return record(offset)->isolation(); }, isolation.size())
+                                 : record(offset)->isolation().substr(0, isolation.size()).compare(isolation);
+            });
+        }
+    }
+    if (!year.empty()) {
+        first_last = filter_by(first_last, [&](offset_t offset) {
+            return keys.keys ? std::string_view{keys[offset].year, ::strnlen(keys[offset].year, hidb::bin::NameKey::year_size)}.compare(year) : record(offset)->year().compare(year);
+        });
     }
-    if (!year.empty())
-        first_last = filter_by(first_last, [aData](hidb::bin::ast_offset_t offset) { return reinterpret_cast<const AgSr*>(aData + offset)->year(); }, year);
     return first_last;
 }
 
@@ -674,28 +1086,26 @@ template <typename AgSr, typename S> inline first_last_t find_by(first_last_t fi
 hidb::AntigenIndexList hidb::Antigens::find(std::string_view aName, fix_location aFixLocation, find_fuzzy fuzzy) const
 {
     const first_last_t all_antigens(reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex), mNumberOfAntigens);
+    const name_index_t keys(mHiDb, hidb::bin::section::antigen_name_keys, hidb::bin::section::antigen_location_tree, all_antigens.first);
     first_last_t first_last;
-    try {
-        std::string virus_type, host, location, isolation, year, passage, extra;
-        virus_name::split_with_extra(aName, virus_type, host, location, isolation, year, passage, extra);
-        if (aFixLocation == fix_location::yes)
-            location = acmacs::locationdb::get().find_or_throw(location).name;
-        first_last = find_by<hidb::bin::Antigen>(all_antigens, mAntigen0, location, isolation, year, fuzzy);
+    if (const auto parsed = mHiDb.name_cache().parse(aName); parsed.recognized) {
+        const auto location = aFixLocation == fix_location::yes ? mHiDb.name_cache().fix_location(parsed.location) : parsed.location;
+        first_last = find_by<hidb::bin::Antigen>(all_antigens, mAntigen0, keys, location, parsed.isolation, parsed.year, fuzzy);
     }
-    catch (virus_name::Unrecognized&) {
+    else {
         if (aName.size() > 3 && aName[2] == ' ') // cdc name?
-            first_last = find_by<hidb::bin::Antigen>(all_antigens, mAntigen0, std::string_view(aName.data(), 2), std::string_view(aName.data() + 3), std::string_view{}, fuzzy);
+            first_last = find_by<hidb::bin::Antigen>(all_antigens, mAntigen0, keys, std::string_view(aName.data(), 2), std::string_view(aName.data() + 3), std::string_view{}, fuzzy);
         if (first_last.empty()) {
             const auto parts = acmacs::string::split(aName, "/");
             switch (parts.size()) {
                 case 1: // just location?
-                    first_last = find_by<hidb::bin::Antigen>(all_antigens, mAntigen0, parts[0], std::string_view{}, std::string_view{}, fuzzy);
+                    first_last = find_by<hidb::bin::Antigen>(all_antigens, mAntigen0, keys, parts[0], std::string_view{}, std::string_view{}, fuzzy);
                     break;
                 case 2: // location/isolation
-                    first_last = find_by<hidb::bin::Antigen>(all_antigens, mAntigen0, parts[0], parts[1], std::string_view{}, fuzzy);
+                    first_last = find_by<hidb::bin::Antigen>(all_antigens, mAntigen0, keys, parts[0], parts[1], std::string_view{}, fuzzy);
                     break;
                 case 3: // host/location/isolation?
-                    first_last = find_by<hidb::bin::Antigen>(all_antigens, mAntigen0, parts[1], parts[2], std::string_view{}, fuzzy);
+                    first_last = find_by<hidb::bin::Antigen>(all_antigens, mAntigen0, keys, parts[1], parts[2], std::string_view{}, fuzzy);
                     break;
                 default: // ?
                     if (parts.size() < 2 || parts[1] != "IND") // A(H3N2)/IND/[PM]/(URI|ENC)/[1-4]/2003 - ignore
@@ -717,28 +1127,26 @@ hidb::AntigenIndexList hidb::Antigens::find(std::string_view aName, fix_location
 hidb::SerumIndexList hidb::Sera::find(std::string_view aName, fix_location aFixLocation, find_fuzzy fuzzy) const
 {
     const first_last_t all_sera(reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex), mNumberOfSera);
+    const name_index_t keys(mHiDb, hidb::bin::section::serum_name_keys, hidb::bin::section::serum_location_tree, all_sera.first);
     first_last_t first_last;
     std::string location;
-    try {
-        std::string virus_type, host, isolation, year, passage, extra;
-        virus_name::split_with_extra(aName, virus_type, host, location, isolation, year, passage, extra);
-        if (aFixLocation == fix_location::yes)
-            location = acmacs::locationdb::get().find_or_throw(location).name;
-        first_last = find_by<hidb::bin::Serum>(all_sera, mSerum0, location, isolation, year, fuzzy);
+    if (const auto parsed = mHiDb.name_cache().parse(aName); parsed.recognized) {
+        location = aFixLocation == fix_location::yes ? mHiDb.name_cache().fix_location(parsed.location) : parsed.location;
+        first_last = find_by<hidb::bin::Serum>(all_sera, mSerum0, keys, location, parsed.isolation, parsed.year, fuzzy);
     }
-    catch (virus_name::Unrecognized&) {
+    else {
         const auto parts = acmacs::string::split(aName, "/");
         switch (parts.size()) {
           case 1:           // just location?
-              first_last = find_by<hidb::bin::Serum>(all_sera, mSerum0, parts[0], std::string_view{}, std::string_view{}, fuzzy);
+              first_last = find_by<hidb::bin::Serum>(all_sera, mSerum0, keys, parts[0], std::string_view{}, std::string_view{}, fuzzy);
               break;
           case 2:           // location/isolation
-              location = aFixLocation == hidb::fix_location::yes ? acmacs::locationdb::get().find_or_throw(std::string(parts[0])).name : std::string(parts[0]);
-              first_last = find_by<hidb::bin::Serum>(all_sera, mSerum0, std::string_view(location), parts[1], std::string_view{}, fuzzy);
+              location = aFixLocation == hidb::fix_location::yes ? mHiDb.name_cache().fix_location(parts[0]) : std::string(parts[0]);
+              first_last = find_by<hidb::bin::Serum>(all_sera, mSerum0, keys, std::string_view(location), parts[1], std::string_view{}, fuzzy);
               break;
           case 3:          // host/location/isolation?
-              location = aFixLocation == hidb::fix_location::yes ? acmacs::locationdb::get().find_or_throw(std::string(parts[1])).name : std::string(parts[1]);
-              first_last = find_by<hidb::bin::Serum>(all_sera, mSerum0, std::string_view(location), parts[2], std::string_view{}, fuzzy);
+              location = aFixLocation == hidb::fix_location::yes ? mHiDb.name_cache().fix_location(parts[1]) : std::string(parts[1]);
+              first_last = find_by<hidb::bin::Serum>(all_sera, mSerum0, keys, std::string_view(location), parts[2], std::string_view{}, fuzzy);
               break;
           default:          // ?
               AD_WARNING("don't know how to split: {}", aName);
@@ -757,45 +1165,91 @@ hidb::SerumIndexList hidb::Sera::find(std::string_view aName, fix_location aFixL
 
 hidb::AntigenPList hidb::Antigens::find_labid(std::string_view labid) const
 {
-    AntigenPList result;
+    AntigenIndexList found;
+    if (labid.find('#') == std::string_view::npos) {
+        found = find_labid_exact(fmt::format("CDC#{}", labid));
+        if (found.empty())
+            found = find_labid_exact(fmt::format("MELB#{}", labid));
+        if (found.empty())
+            found = find_labid_exact(fmt::format("NIID#{}", labid));
+    }
+    if (found.empty())
+        found = find_labid_exact(labid);
 
-    auto find = [&result, this](std::string look_for) -> void {
-        const first_last_t all_antigens(reinterpret_cast<const hidb::bin::ast_offset_t*>(this->mIndex), this->mNumberOfAntigens);
-        for (auto ag = all_antigens.first; ag != all_antigens.last; ++ag) {
-            const auto lab_ids = reinterpret_cast<const hidb::bin::Antigen*>(this->mAntigen0 + *ag)->lab_ids();
-            if (const auto found = std::find(lab_ids.begin(), lab_ids.end(), look_for); found != lab_ids.end())
-                result.push_back(std::make_shared<Antigen>(this->mAntigen0 + *ag, mHiDb));
-        }
-    };
+    return list(found);
 
-    if (labid.find('#') == std::string_view::npos) {
-        find(fmt::format("CDC#{}", labid));
-        if (result.empty())
-            find(fmt::format("MELB#{}", labid));
-        if (result.empty())
-            find(fmt::format("NIID#{}", labid));
+} // hidb::Antigens::find_labid
+
+// ----------------------------------------------------------------------
+
+hidb::AntigenIndexList hidb::Antigens::find_labid_exact(std::string_view labid) const
+{
+    AntigenIndexList result;
+    const auto antigens = bin::antigens(mHiDb.data());
+    if (const bin::HashIndex index{mHiDb.section(bin::section::antigen_lab_ids)}; !index.empty()) {
+        index.find(labid, [&](size_t antigen_no) {
+            if (antigens[antigen_no].has_lab_id(labid))
+                result.emplace_back(antigen_no);
+            return false; // lab id may be shared by several antigens
+        });
+        std::sort(result.begin(), result.end());
     }
-    if (result.empty())
-        find(std::string{labid});
+    else {
+        for (size_t antigen_no = 0; antigen_no < antigens.size(); ++antigen_no) {
+            if (antigens[antigen_no].has_lab_id(labid))
+                result.emplace_back(antigen_no);
+        }
+    }
+    return result;
+
+} // hidb::Antigens::find_labid_exact
 
+// ----------------------------------------------------------------------
+
+template <typename Part, typename Index> static std::optional<Index> find_full_name(const hidb::HiDb& aHiDb, const Part& aPart, hidb::bin::section_id_t aSectionId, std::string_view aFullName)
+{
+    if (const auto virus_type = aHiDb.virus_type(); aFullName.size() > virus_type.size() && aFullName.substr(0, virus_type.size()) == virus_type && aFullName[virus_type.size()] == '/')
+        aFullName.remove_prefix(virus_type.size() + 1);
+
+    std::optional<Index> result;
+    if (const hidb::bin::HashIndex index{aHiDb.section(aSectionId)}; !index.empty()) {
+        index.find(aFullName, [&](size_t no) {
+            if (aPart[no].has_full_name(aFullName, aHiDb.strings()))
+                result = Index{no};
+            return result.has_value();
+        });
+    }
+    else {
+        for (size_t no = 0; no < aPart.size() && !result; ++no) {
+            if (aPart[no].has_full_name(aFullName, aHiDb.strings()))
+                result = Index{no};
+        }
+    }
     return result;
 
-} // hidb::Antigens::find_labid
+} // find_full_name
+
+std::optional<hidb::AntigenIndex> hidb::Antigens::find_full_name(std::string_view aFullName) const
+{
+    return ::find_full_name<bin::Part<bin::Antigen>, AntigenIndex>(mHiDb, bin::antigens(mHiDb.data()), bin::section::antigen_full_names, aFullName);
+
+} // hidb::Antigens::find_full_name
 
 // ----------------------------------------------------------------------
 
 // for seqdb-3, to speed up looking by lab_id
 std::vector<std::pair<std::string_view, const hidb::bin::Antigen*>> hidb::Antigens::sorted_by_labid() const
 {
-    std::vector<std::pair<std::string_view, const hidb::bin::Antigen*>> result;
-    const first_last_t all_antigens(reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex), mNumberOfAntigens);
-    for (const auto& ag : all_antigens) {
-        const auto* antigen = reinterpret_cast<const hidb::bin::Antigen*>(mAntigen0 + ag);
-        for (const auto& lab_id : antigen->lab_ids())
-            result.emplace_back(lab_id, antigen);
-    }
-    std::sort(std::begin(result), std::end(result), [](const auto& e1, const auto& e2) { return e1.first < e2.first; });
-    return result;
+    std::call_once(mSortedByLabIdMade, [this]() {
+        const first_last_t all_antigens(reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex), mNumberOfAntigens);
+        for (const auto& ag : all_antigens) {
+            const auto* antigen = reinterpret_cast<const hidb::bin::Antigen*>(mAntigen0 + ag);
+            for (const auto& lab_id : antigen->lab_ids())
+                mSortedByLabId.emplace_back(lab_id, antigen);
+        }
+        std::sort(std::begin(mSortedByLabId), std::end(mSortedByLabId), [](const auto& e1, const auto& e2) { return e1.first < e2.first; });
+    });
+    return mSortedByLabId;
 
 } // hidb::Antigens::sorted_by_labid
 
@@ -831,12 +1285,8 @@ std::optional<hidb::AntigenPIndex> hidb::Antigens::find(const acmacs::chart::Ant
 hidb::AntigenPList hidb::Antigens::find(const acmacs::chart::Antigens& aAntigens) const
 {
     hidb::AntigenPList result;
-    for (auto antigen : aAntigens) {
-        if (const auto found = find(*antigen); found.has_value())
-            result.push_back(found->first);
-        else
-            result.emplace_back(nullptr);
-    }
+    for (const auto& found : find_all(aAntigens))
+        result.push_back(found.has_value() ? at(*found) : nullptr);
     return result;
 
 } // hidb::Antigens::find
@@ -846,12 +1296,8 @@ hidb::AntigenPList hidb::Antigens::find(const acmacs::chart::Antigens& aAntigens
 hidb::AntigenPList hidb::Antigens::find(const acmacs::chart::Antigens& aAntigens, const acmacs::chart::Indexes& indexes) const
 {
     hidb::AntigenPList result;
-    for (auto antigen_no: indexes) {
-        if (const auto found = find(*aAntigens[antigen_no]); found.has_value())
-            result.push_back(found->first);
-        else
-            result.emplace_back(nullptr);
-    }
+    for (const auto& found : find_all(aAntigens, indexes))
+        result.push_back(found.has_value() ? at(*found) : nullptr);
     return result;
 
 } // hidb::Antigens::find
@@ -882,12 +1328,8 @@ std::optional<hidb::SerumPIndex> hidb::Sera::find(const acmacs::chart::Serum& aS
 hidb::SerumPList hidb::Sera::find(const acmacs::chart::Sera& aSera) const
 {
     hidb::SerumPList result;
-    for (auto serum: aSera) {
-        if (const auto found = find(*serum); found)
-            result.push_back(found->first);
-        else
-            result.emplace_back(nullptr);
-    }
+    for (const auto& found : find_all(aSera))
+        result.push_back(found.has_value() ? at(*found) : nullptr);
     return result;
 
 } // hidb::Sera::find
@@ -897,45 +1339,275 @@ hidb::SerumPList hidb::Sera::find(const acmacs::chart::Sera& aSera) const
 hidb::SerumPList hidb::Sera::find(const acmacs::chart::Sera& aSera, const acmacs::chart::Indexes& indexes) const
 {
     hidb::SerumPList result;
-    for (auto serum_no: indexes) {
-        if (const auto found = find(*aSera[serum_no]); found)
-            result.push_back(found->first);
-        else
-            result.emplace_back(nullptr);
-    }
+    for (const auto& found : find_all(aSera, indexes))
+        result.push_back(found.has_value() ? at(*found) : nullptr);
     return result;
 
 } // hidb::Sera::find
 
+// ----------------------------------------------------------------------
+// batch matching of chart antigens (sera): parsed names are sorted the same way as antigens (sera) of hidb (by location, isolation, year)
+// and merged with them, the cursor in hidb only moves forward
+
+struct chart_name_t
+{
+    std::string location;
+    std::string isolation;
+    std::string year;
+    size_t no; // in the list being matched
+
+    bool operator<(const chart_name_t& rhs) const { return std::tie(location, isolation, year, no) < std::tie(rhs.location, rhs.isolation, rhs.year, rhs.no); }
+};
+
+template <typename AgSr> inline std::string_view year_of(const AgSr& aRecord) { return aRecord.year_data[0] ? std::string_view{aRecord.year_data, sizeof(aRecord.year_data)} : std::string_view{}; }
+
+template <typename AgSr> inline int compare_name(const AgSr& aRecord, const hidb::bin::Strings& aStrings, const chart_name_t& aName)
+{
+    if (const auto cmp = aRecord.location(aStrings).compare(aName.location); cmp != 0)
+        return cmp;
+    if (const auto cmp = aRecord.isolation().compare(aName.isolation); cmp != 0)
+        return cmp;
+    return year_of(aRecord).compare(aName.year);
+}
+
+  // the same as find_by() with find_fuzzy::no, empty isolation (year) matches any
+template <typename AgSr> inline bool matches_name(const AgSr& aRecord, const hidb::bin::Strings& aStrings, const chart_name_t& aName)
+{
+    return aRecord.location(aStrings) == aName.location && (aName.isolation.empty() || (aRecord.isolation() == aName.isolation && (aName.year.empty() || year_of(aRecord) == aName.year)));
+}
+
+  // first element in [first, last) for which aLess(element) is false, aLess is partitioned, exponential search from first
+template <typename F> inline offset_t gallop(offset_t first, offset_t last, F aLess)
+{
+    auto bound = first;
+    for (size_t step = 1; bound != last && aLess(*bound); step *= 2) {
+        first = bound + 1;
+        bound = static_cast<size_t>(last - first) > step ? first + step : last;
+    }
+    return std::partition_point(first, bound, aLess);
+}
+
+  // aNames are sorted, aCandidate(no, index, record) is called for each hidb record matching name of aNames[no] in the order of records, until it returns true
+template <typename AgSr, typename F> inline void merge_names(first_last_t aAll, const char* aData, const hidb::bin::Strings& aStrings, std::vector<chart_name_t>& aNames, F aCandidate)
+{
+    const auto record = [aData](offset_t offset) -> const AgSr& { return *reinterpret_cast<const AgSr*>(aData + *offset); };
+    std::sort(aNames.begin(), aNames.end());
+    auto cursor = aAll.first;
+    for (const auto& name : aNames) {
+        cursor = gallop(cursor, aAll.last, [&](const hidb::bin::ast_offset_t& offset) { return compare_name(record(&offset), aStrings, name) < 0; });
+        for (auto offset = cursor; offset != aAll.last && matches_name(record(offset), aStrings, name); ++offset) {
+            if (aCandidate(name.no, static_cast<size_t>(offset - aAll.first), record(offset)))
+                break;
+        }
+    }
+}
+
+  // false if name cannot be matched by merging (virus_name::Unrecognized or year without isolation), find() for a single antigen (serum) is used then
+inline bool parse_chart_name(hidb::NameCache& aCache, std::string_view aName, size_t aNo, std::vector<chart_name_t>& aNames)
+{
+    auto parsed = aCache.parse(aName);
+    if (!parsed.recognized || (parsed.isolation.empty() && !parsed.year.empty()))
+        return false;
+    aNames.push_back(chart_name_t{std::move(parsed.location), std::move(parsed.isolation), std::move(parsed.year), aNo});
+    return true;
+}
+
+// ----------------------------------------------------------------------
+
+std::vector<std::optional<hidb::AntigenIndex>> hidb::Antigens::find_all(const acmacs::chart::Antigens& aAntigens, passage_strictness aPassageStrictness) const
+{
+    std::vector<std::shared_ptr<acmacs::chart::Antigen>> antigens;
+    for (auto antigen : aAntigens)
+        antigens.push_back(antigen);
+    return find_all(antigens, aPassageStrictness);
+
+} // hidb::Antigens::find_all
+
+// ----------------------------------------------------------------------
+
+std::vector<std::optional<hidb::AntigenIndex>> hidb::Antigens::find_all(const acmacs::chart::Antigens& aAntigens, const acmacs::chart::Indexes& indexes, passage_strictness aPassageStrictness) const
+{
+    std::vector<std::shared_ptr<acmacs::chart::Antigen>> antigens;
+    for (auto antigen_no : indexes)
+        antigens.push_back(aAntigens[antigen_no]);
+    return find_all(antigens, aPassageStrictness);
+
+} // hidb::Antigens::find_all
+
+// ----------------------------------------------------------------------
+
+std::vector<std::optional<hidb::AntigenIndex>> hidb::Antigens::find_all(const std::vector<std::shared_ptr<acmacs::chart::Antigen>>& aAntigens, passage_strictness aPassageStrictness) const
+{
+    struct expected_t
+    {
+        acmacs::chart::Annotations annotations;
+        acmacs::virus::Reassortant reassortant;
+        acmacs::virus::Passage passage;
+        bool ignore_passage;
+    };
+
+    std::vector<std::optional<AntigenIndex>> result(aAntigens.size());
+    std::vector<expected_t> expected(aAntigens.size());
+    std::vector<chart_name_t> names;
+    names.reserve(aAntigens.size());
+    for (size_t no = 0; no < aAntigens.size(); ++no) {
+        const auto& antigen = *aAntigens[no];
+        if (antigen.annotations().distinct()) // distinct antigens are not stored
+            throw not_found(antigen.name_full());
+        if (parse_chart_name(mHiDb.name_cache(), *antigen.name(), no, names)) {
+            const auto passage = antigen.passage();
+            expected[no] = expected_t{antigen.annotations(), antigen.reassortant(), passage,
+                                      aPassageStrictness == passage_strictness::ignore || (aPassageStrictness == passage_strictness::ignore_if_empty && passage.empty())};
+        }
+        else if (const auto found = find(antigen, aPassageStrictness); found.has_value())
+            result[no] = found->second;
+    }
+
+    merge_names<hidb::bin::Antigen>(first_last_t(reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex), mNumberOfAntigens), mAntigen0, mHiDb.strings(), names,
+                                    [&result, &expected, &strings = mHiDb.strings()](size_t no, size_t antigen_index, const hidb::bin::Antigen& antigen) {
+                                        const auto& exp = expected[no];
+                                        if (acmacs::virus::Reassortant{antigen.reassortant()} == exp.reassortant && (exp.ignore_passage || acmacs::virus::Passage{antigen.passage(strings)} == exp.passage) &&
+                                            make_annotations(antigen.annotations()) == exp.annotations) {
+                                            result[no] = AntigenIndex{antigen_index};
+                                            return true;
+                                        }
+                                        return false;
+                                    });
+    return result;
+
+} // hidb::Antigens::find_all
+
+// ----------------------------------------------------------------------
+
+std::vector<std::optional<hidb::SerumIndex>> hidb::Sera::find_all(const acmacs::chart::Sera& aSera) const
+{
+    std::vector<std::shared_ptr<acmacs::chart::Serum>> sera;
+    for (auto serum : aSera)
+        sera.push_back(serum);
+    return find_all(sera);
+
+} // hidb::Sera::find_all
+
+// ----------------------------------------------------------------------
+
+std::vector<std::optional<hidb::SerumIndex>> hidb::Sera::find_all(const acmacs::chart::Sera& aSera, const acmacs::chart::Indexes& indexes) const
+{
+    std::vector<std::shared_ptr<acmacs::chart::Serum>> sera;
+    for (auto serum_no : indexes)
+        sera.push_back(aSera[serum_no]);
+    return find_all(sera);
+
+} // hidb::Sera::find_all
+
+// ----------------------------------------------------------------------
+
+std::vector<std::optional<hidb::SerumIndex>> hidb::Sera::find_all(const std::vector<std::shared_ptr<acmacs::chart::Serum>>& aSera) const
+{
+    struct expected_t
+    {
+        acmacs::chart::Annotations annotations;
+        acmacs::virus::Reassortant reassortant;
+        acmacs::chart::SerumId serum_id;
+        std::optional<SerumIndex> with_unknown_serum_id; // old tables may have UNKNOWN serum id, but database stores empty serum_id
+    };
+
+    std::vector<std::optional<SerumIndex>> result(aSera.size());
+    std::vector<expected_t> expected(aSera.size());
+    std::vector<chart_name_t> names;
+    names.reserve(aSera.size());
+    for (size_t no = 0; no < aSera.size(); ++no) {
+        const auto& serum = *aSera[no];
+        if (parse_chart_name(mHiDb.name_cache(), *serum.name(), no, names))
+            expected[no] = expected_t{serum.annotations(), serum.reassortant(), serum.serum_id(), std::nullopt};
+        else if (const auto found = find(serum); found.has_value())
+            result[no] = SerumIndex{found->second};
+    }
+
+    merge_names<hidb::bin::Serum>(first_last_t(reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex), mNumberOfSera), mSerum0, mHiDb.strings(), names,
+                                  [&result, &expected](size_t no, size_t serum_index, const hidb::bin::Serum& serum) {
+                                      auto& exp = expected[no];
+                                      if (acmacs::virus::Reassortant{serum.reassortant()} == exp.reassortant && make_annotations(serum.annotations()) == exp.annotations) {
+                                          if (acmacs::chart::SerumId{serum.serum_id()} == exp.serum_id) {
+                                              result[no] = SerumIndex{serum_index};
+                                              return true;
+                                          }
+                                          else if (serum.serum_id().empty() && exp.serum_id == acmacs::chart::SerumId{"UNKNOWN"})
+                                              exp.with_unknown_serum_id = SerumIndex{serum_index};
+                                      }
+                                      return false;
+                                  });
+    for (size_t no = 0; no < aSera.size(); ++no) {
+        if (!result[no].has_value())
+            result[no] = expected[no].with_unknown_serum_id;
+    }
+    return result;
+
+} // hidb::Sera::find_all
+
 // ----------------------------------------------------------------------
 
 hidb::AntigenPList hidb::Antigens::date_range(std::string_view first, std::string_view after_last) const
 {
-    hidb::AntigenPList result;
     const auto min_date = !first.empty() ? hidb::bin::Antigen::make_date(first) : hidb::bin::Antigen::min_date();
     const auto max_date = !after_last.empty() ? hidb::bin::Antigen::make_date(after_last) : hidb::bin::Antigen::max_date();
-    const first_last_t all_antigens(reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex), mNumberOfAntigens);
-    for (auto ag = all_antigens.first; ag != all_antigens.last; ++ag) {
-        const auto date = reinterpret_cast<const hidb::bin::Antigen*>(this->mAntigen0 + *ag)->date_raw();
-        if (date >= min_date && date < max_date)
-            result.push_back(std::make_shared<Antigen>(this->mAntigen0 + *ag, mHiDb));
-    }
-    return result;
+    const auto [begin, end] = by_date(min_date, max_date);
+    AntigenIndexList indexes(static_cast<size_t>(end - begin));
+    std::transform(begin, end, indexes.begin(), [](const auto& entry) { return AntigenIndex{entry.antigen}; });
+    std::sort(indexes.begin(), indexes.end()); // in the order of antigens as before
+    return list(indexes);
 
 } // hidb::Antigens::date_range
 
 // ----------------------------------------------------------------------
 
+std::pair<const hidb::bin::DatedAntigen*, const hidb::bin::DatedAntigen*> hidb::Antigens::by_date(bin::date_t aFirst, bin::date_t aAfterLast) const
+{
+    const bin::DatedAntigen *begin, *end;
+    if (const auto section = mHiDb.section(bin::section::antigens_by_date); !section.empty()) {
+        begin = reinterpret_cast<const bin::DatedAntigen*>(section.data());
+        end = begin + section.size() / sizeof(bin::DatedAntigen);
+    }
+    else {
+        std::call_once(mByDateMade, [this]() {
+            const first_last_t all_antigens(reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex), mNumberOfAntigens);
+            for (auto ag = all_antigens.first; ag != all_antigens.last; ++ag)
+                mByDate.push_back(bin::DatedAntigen{reinterpret_cast<const hidb::bin::Antigen*>(mAntigen0 + *ag)->date_raw(), static_cast<bin::antigen_index_t>(ag - all_antigens.first)});
+            std::sort(mByDate.begin(), mByDate.end(), [](const auto& e1, const auto& e2) { return e1.date == e2.date ? e1.antigen < e2.antigen : e1.date < e2.date; });
+        });
+        begin = mByDate.data();
+        end = begin + mByDate.size();
+    }
+    const auto less_than = [](const bin::DatedAntigen& entry, bin::date_t look_for) { return entry.date < look_for; };
+    const auto* first = std::lower_bound(begin, end, aFirst, less_than);
+    return {first, std::lower_bound(first, end, aAfterLast, less_than)};
+
+} // hidb::Antigens::by_date
+
+// ----------------------------------------------------------------------
+
 hidb::SerumPList hidb::Sera::find_homologous(size_t aAntigenIndex, const Antigen& aAntigen) const
 {
-    const first_last_t all_sera(reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex), mNumberOfSera);
     const std::string antigen_year(aAntigen.year());
-    const first_last_t first_last = find_by<hidb::bin::Serum>(all_sera, mSerum0, aAntigen.location(), aAntigen.isolation(), std::string_view(antigen_year), find_fuzzy::no);
     hidb::SerumPList result;
+    if (const auto section = mHiDb.section(bin::section::homologous_sera); !section.empty()) {
+          // sera having antigen as homologous, name is checked to keep the result the same as the search below
+        const auto [num_sera, serum_indexes] = bin::homologous_sera(section, bin::antigens(mHiDb.data()).size(), aAntigenIndex);
+        const auto* index = reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex);
+        for (const auto* serum_index = serum_indexes; serum_index != serum_indexes + num_sera; ++serum_index) {
+            const auto* serum = reinterpret_cast<const hidb::bin::Serum*>(mSerum0 + index[*serum_index]);
+            if (serum->location(mHiDb.strings()) == aAntigen.location() && (aAntigen.isolation().empty() || serum->isolation() == aAntigen.isolation()) && (antigen_year.empty() || serum->year() == antigen_year))
+                result.push_back(at(SerumIndex{*serum_index}));
+        }
+        return result;
+    }
+
+    const first_last_t all_sera(reinterpret_cast<const hidb::bin::ast_offset_t*>(mIndex), mNumberOfSera);
+    const name_index_t keys(mHiDb, hidb::bin::section::serum_name_keys, hidb::bin::section::serum_location_tree, all_sera.first);
+    const first_last_t first_last = find_by<hidb::bin::Serum>(all_sera, mSerum0, keys, aAntigen.location(), aAntigen.isolation(), std::string_view(antigen_year), find_fuzzy::no);
     for (auto offset_p = first_last.first; offset_p != first_last.last; ++offset_p) {
         const auto [num_homologous, first_homologous_p] = reinterpret_cast<const hidb::bin::Serum*>(mSerum0 + *offset_p)->homologous_antigens();
         if (std::find(first_homologous_p, first_homologous_p + num_homologous, aAntigenIndex) != (first_homologous_p + num_homologous)) {
-            result.push_back(std::make_shared<hidb::Serum>(mSerum0 + *offset_p, mHiDb));
+            result.push_back(at(SerumIndex{static_cast<size_t>(offset_p - all_sera.first)}));
         }
     }
     // AD_DEBUG("find_homologous {} \"{}\" {}", aAntigenIndex, aAntigen.name_full(), result.size());
@@ -944,3 +1616,201 @@ hidb::SerumPList hidb::Sera::find_homologous(size_t aAntigenIndex, const Antigen
 } // hidb::Sera::find_homologous
 
 // ----------------------------------------------------------------------
+
+hidb::SerumIndexList hidb::Sera::find_serum_id(std::string_view aSerumId) const
+{
+    SerumIndexList result;
+    const auto sera = bin::sera(mHiDb.data());
+    if (const bin::HashIndex index{mHiDb.section(bin::section::serum_ids)}; !index.empty()) {
+        index.find(aSerumId, [&](size_t serum_no) {
+            if (sera[serum_no].serum_id() == aSerumId)
+                result.emplace_back(serum_no);
+            return false; // serum id may be shared by several sera
+        });
+        std::sort(result.begin(), result.end());
+    }
+    else {
+        for (size_t serum_no = 0; serum_no < sera.size(); ++serum_no) {
+            if (sera[serum_no].serum_id() == aSerumId)
+                result.emplace_back(serum_no);
+        }
+    }
+    return result;
+
+} // hidb::Sera::find_serum_id
+
+// ----------------------------------------------------------------------
+
+std::optional<hidb::SerumIndex> hidb::Sera::find_full_name(std::string_view aFullName) const
+{
+    return ::find_full_name<bin::Part<bin::Serum>, SerumIndex>(mHiDb, bin::sera(mHiDb.data()), bin::section::serum_full_names, aFullName);
+
+} // hidb::Sera::find_full_name
+
+// ----------------------------------------------------------------------
+
+  // optimal string alignment distance: insertions, deletions, substitutions and transpositions of adjacent characters
+  // aRows is a buffer reused between calls
+inline size_t edit_distance(std::string_view aSource, std::string_view aTarget, std::vector<size_t>& aRows)
+{
+    const auto width = aTarget.size() + 1;
+    aRows.resize(width * 3);
+    auto* before_previous = aRows.data();
+    auto* previous = before_previous + width;
+    auto* current = previous + width;
+    std::iota(previous, previous + width, size_t{0});
+    for (size_t src = 1; src <= aSource.size(); ++src) {
+        current[0] = src;
+        for (size_t trg = 1; trg < width; ++trg) {
+            current[trg] = std::min({previous[trg] + 1, current[trg - 1] + 1, previous[trg - 1] + (aSource[src - 1] == aTarget[trg - 1] ? 0 : 1)});
+            if (src > 1 && trg > 1 && aSource[src - 1] == aTarget[trg - 2] && aSource[src - 2] == aTarget[trg - 1])
+                current[trg] = std::min(current[trg], before_previous[trg - 2] + 1);
+        }
+        std::swap(before_previous, previous);
+        std::swap(previous, current);
+    }
+    return previous[aTarget.size()];
+}
+
+  // LOCATION/ISOLATION/YEAR of aName, cdc names (LOC ISOLATION) and LOCATION/ISOLATION names are used with spaces replaced by slashes
+inline std::string similarity_key(hidb::NameCache& aCache, std::string_view aName)
+{
+    if (const auto parsed = aCache.parse(aName); parsed.recognized)
+        return hidb::bin::similarity_key(parsed.location, parsed.isolation, parsed.year);
+    std::string key{aName};
+    std::replace(key.begin(), key.end(), ' ', '/');
+    return key;
+}
+
+template <typename Index, typename Part> static std::vector<hidb::similar_t<Index>> find_similar(const hidb::bin::TrigramIndex& aTrigrams, const Part& aPart, const hidb::bin::Strings& aStrings, const std::string& aKey, size_t aNumber)
+{
+    std::vector<hidb::bin::trigram_t> trigrams;
+    hidb::bin::for_each_trigram(aKey, [&trigrams](hidb::bin::trigram_t trigram) { trigrams.push_back(trigram); });
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    std::vector<uint16_t> shared(aPart.size(), 0); // number of trigrams of aKey found in the key of each record
+    std::vector<uint32_t> candidates;
+    for (const auto trigram : trigrams) {
+        const auto [first, last] = aTrigrams.find(trigram);
+        for (const auto* record_no = first; record_no != last; ++record_no) {
+            if (shared[*record_no]++ == 0)
+                candidates.push_back(*record_no);
+        }
+    }
+
+      // edit distance is computed just for the candidates sharing the most trigrams
+    if (const auto number_to_check = std::max(aNumber * 16, size_t{256}); candidates.size() > number_to_check) {
+        std::nth_element(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(number_to_check), candidates.end(),
+                         [&shared](uint32_t c1, uint32_t c2) { return shared[c1] == shared[c2] ? c1 < c2 : shared[c1] > shared[c2]; });
+        candidates.resize(number_to_check);
+    }
+
+    std::vector<size_t> rows;
+    std::vector<hidb::similar_t<Index>> result;
+    for (const auto record_no : candidates) {
+        const auto& rec = aPart[record_no];
+        result.push_back(hidb::similar_t<Index>{Index{record_no}, edit_distance(aKey, hidb::bin::similarity_key(rec.location(aStrings), rec.isolation(), rec.year()), rows)});
+    }
+    const auto closer = [](const auto& e1, const auto& e2) { return e1.distance == e2.distance ? e1.index < e2.index : e1.distance < e2.distance; };
+    if (result.size() > aNumber) {
+        std::partial_sort(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(aNumber), result.end(), closer);
+        result.resize(aNumber);
+    }
+    else
+        std::sort(result.begin(), result.end(), closer);
+    return result;
+
+} // find_similar
+
+// ----------------------------------------------------------------------
+
+std::vector<hidb::similar_t<hidb::AntigenIndex>> hidb::Antigens::find_similar(std::string_view aName, size_t aNumber) const
+{
+    return ::find_similar<AntigenIndex>(trigrams(), bin::antigens(mHiDb.data()), mHiDb.strings(), similarity_key(mHiDb.name_cache(), aName), aNumber);
+
+} // hidb::Antigens::find_similar
+
+// ----------------------------------------------------------------------
+
+hidb::bin::TrigramIndex hidb::Antigens::trigrams() const
+{
+    if (const auto section = mHiDb.section(bin::section::antigen_trigrams); !section.empty())
+        return bin::TrigramIndex{section};
+    std::call_once(mTrigramsStorageMade, [this]() { mTrigramsStorage = bin::antigen_trigrams_section(mHiDb.data(), mHiDb.strings()); });
+    return bin::TrigramIndex{mTrigramsStorage};
+
+} // hidb::Antigens::trigrams
+
+// ----------------------------------------------------------------------
+
+std::vector<hidb::similar_t<hidb::SerumIndex>> hidb::Sera::find_similar(std::string_view aName, size_t aNumber) const
+{
+    return ::find_similar<SerumIndex>(trigrams(), bin::sera(mHiDb.data()), mHiDb.strings(), similarity_key(mHiDb.name_cache(), aName), aNumber);
+
+} // hidb::Sera::find_similar
+
+// ----------------------------------------------------------------------
+
+hidb::bin::TrigramIndex hidb::Sera::trigrams() const
+{
+    if (const auto section = mHiDb.section(bin::section::serum_trigrams); !section.empty())
+        return bin::TrigramIndex{section};
+    std::call_once(mTrigramsStorageMade, [this]() { mTrigramsStorage = bin::serum_trigrams_section(mHiDb.data(), mHiDb.strings()); });
+    return bin::TrigramIndex{mTrigramsStorage};
+
+} // hidb::Sera::trigrams
+
+// ----------------------------------------------------------------------
+
+template <typename Index> static std::vector<hidb::completion_t<Index>> complete(const hidb::bin::Completions& aCompletions, std::string_view aVirusType, std::string_view aPrefix, size_t aNumber)
+{
+    if (aPrefix.size() > aVirusType.size() && aPrefix.substr(0, aVirusType.size()) == aVirusType && aPrefix[aVirusType.size()] == '/')
+        aPrefix.remove_prefix(aVirusType.size() + 1);
+
+    std::vector<hidb::completion_t<Index>> result;
+    for (const auto no : aCompletions.top(aPrefix, aNumber))
+        result.push_back(hidb::completion_t<Index>{std::string{aCompletions.name(no)}, aCompletions.number_of_tables(no), Index{aCompletions.first(no)}});
+    return result;
+
+} // complete
+
+// ----------------------------------------------------------------------
+
+std::vector<hidb::completion_t<hidb::AntigenIndex>> hidb::Antigens::complete(std::string_view aPrefix, size_t aNumber) const
+{
+    return ::complete<AntigenIndex>(completions(), mHiDb.virus_type(), aPrefix, aNumber);
+
+} // hidb::Antigens::complete
+
+// ----------------------------------------------------------------------
+
+hidb::bin::Completions hidb::Antigens::completions() const
+{
+    if (const auto section = mHiDb.section(bin::section::antigen_completions); !section.empty())
+        return bin::Completions{section};
+    std::call_once(mCompletionsStorageMade, [this]() { mCompletionsStorage = bin::antigen_completions_section(mHiDb.data(), mHiDb.strings()); });
+    return bin::Completions{mCompletionsStorage};
+
+} // hidb::Antigens::completions
+
+// ----------------------------------------------------------------------
+
+std::vector<hidb::completion_t<hidb::SerumIndex>> hidb::Sera::complete(std::string_view aPrefix, size_t aNumber) const
+{
+    return ::complete<SerumIndex>(completions(), mHiDb.virus_type(), aPrefix, aNumber);
+
+} // hidb::Sera::complete
+
+// ----------------------------------------------------------------------
+
+hidb::bin::Completions hidb::Sera::completions() const
+{
+    if (const auto section = mHiDb.section(bin::section::serum_completions); !section.empty())
+        return bin::Completions{section};
+    std::call_once(mCompletionsStorageMade, [this]() { mCompletionsStorage = bin::serum_completions_section(mHiDb.data(), mHiDb.strings()); });
+    return bin::Completions{mCompletionsStorage};
+
+} // hidb::Sera::completions
+
+// ----------------------------------------------------------------------
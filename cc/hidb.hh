@@ -1,19 +1,27 @@
 #pragma once
 
+#include <mutex>
+
 #include "acmacs-base/read-file.hh"
 #include "acmacs-base/named-type.hh"
+#include "acmacs-base/string.hh"
 #include "locationdb/locdb.hh"
 #include "acmacs-chart-2/chart.hh"
 #include "hidb-5/hidb-set.hh"
+#include "hidb-5/hidb-bin.hh"
+#include "hidb-5/hidb-titer-decoder.hh"
+#include "hidb-5/hidb-name-parser.hh"
 
 // ----------------------------------------------------------------------
 
 namespace hidb
 {
-    namespace bin { struct Table; struct Antigen; }
-
     using TableIndex = acmacs::named_size_t<struct TableIndex_tag>;
     using TableIndexList = std::vector<TableIndex>;
+    using AntigenIndex = acmacs::named_size_t<struct AntigenIndex_tag>;
+    using AntigenIndexList = std::vector<AntigenIndex>;
+    using SerumIndex = acmacs::named_size_t<struct SerumIndex_tag>;
+    using SerumIndexList = std::vector<SerumIndex>;
 
     class error : public std::runtime_error { public: using std::runtime_error::runtime_error; };
     class not_found : public error { public: using error::error; };
@@ -22,12 +30,173 @@ namespace hidb
     enum class fix_location { no, yes };
     enum class passage_strictness { yes, ignore_if_empty, ignore };
 
+      // entry of Antigens::find_similar() and Sera::find_similar() result
+    template <typename Index> struct similar_t
+    {
+        Index index;
+        size_t distance; // edit distance (with transpositions) between LOCATION/ISOLATION/YEAR of the name looked for and of the antigen (serum)
+    };
+
+      // entry of Antigens::complete() and Sera::complete() result
+    template <typename Index> struct completion_t
+    {
+        std::string name;        // without virus type, see bin::Antigen::name(), bin::Serum::name()
+        size_t number_of_tables; // tables of all antigens (sera) with this name
+        Index first;             // the first antigen (serum) with this name
+    };
+
     class HiDb;
+    class BitmapIndex;
+
+      // throws hidb::error, titers of hidb5b with format version 0 are in the order of source charts and cannot be read (see bin::FormatVersion)
+    [[noreturn]] void titers_not_in_index_order();
+
+      // ----------------------------------------------------------------------
+      // Allocation-free views of antigens, sera and tables, trivially copyable, valid while HiDb is alive
+      // accessors match Antigen, Serum and Table but return views into hidb5b data where possible, Antigen, Serum and Table are implemented on top of them
+      // Antigens::make(&ref.record()) (Sera::make) makes acmacs::chart::Antigen (Serum) compatible object if needed
+
+      // context of AntigenRef and SerumRef
+    struct ast_context_t
+    {
+        std::string_view virus_type;
+        const bin::Strings* strings; // see HiDb::strings()
+    };
+
+    class AntigenRef
+    {
+     public:
+        using index_t = AntigenIndex;
+        using context_t = ast_context_t;
+
+        AntigenRef(const bin::Antigen& aRecord, AntigenIndex aIndex, const context_t& aContext) : mRecord{&aRecord}, mIndex{aIndex}, mVirusType{aContext.virus_type}, mStrings{aContext.strings} {}
+
+        AntigenIndex index() const { return mIndex; }
+        const bin::Antigen& record() const { return *mRecord; }
+
+        std::string name() const { return mRecord->cdc_name() ? mRecord->name(*mStrings) : acmacs::string::concat(mVirusType, "/", mRecord->name(*mStrings)); }
+        std::string date() const { return mRecord->date(false); }
+        std::string date_compact() const { return mRecord->date(true); }
+        bin::date_t date_raw() const { return mRecord->date_raw(); }
+        std::string_view host() const { return mRecord->host(*mStrings); }
+        std::string_view passage() const { return mRecord->passage(*mStrings); }
+        acmacs::chart::BLineage lineage() const { return mRecord->lineage; }
+        std::string_view reassortant() const { return mRecord->reassortant(); }
+        std::vector<std::string_view> lab_ids() const { return mRecord->lab_ids(); }
+        std::vector<std::string_view> annotations() const { return mRecord->annotations(); }
+
+        bin::span<bin::table_index_t> tables() const { const auto [size, ptr] = mRecord->tables(); return {ptr, size}; }
+        size_t number_of_tables() const { return mRecord->tables().first; }
+
+        std::string_view location() const { return mRecord->location(*mStrings); }
+        std::string_view isolation() const { return mRecord->isolation(); }
+        std::string year() const { return mRecord->year(); }
+        std::string_view country(const LocDb& locdb) const noexcept;
+
+        std::string full_name() const { return mRecord->cdc_name() ? mRecord->full_name(*mStrings) : acmacs::string::concat(mVirusType, "/", mRecord->full_name(*mStrings)); }
+
+     private:
+        const bin::Antigen* mRecord;
+        AntigenIndex mIndex;
+        std::string_view mVirusType;
+        const bin::Strings* mStrings;
+
+    }; // class AntigenRef
+
+    class SerumRef
+    {
+     public:
+        using index_t = SerumIndex;
+        using context_t = ast_context_t;
+
+        SerumRef(const bin::Serum& aRecord, SerumIndex aIndex, const context_t& aContext) : mRecord{&aRecord}, mIndex{aIndex}, mVirusType{aContext.virus_type}, mStrings{aContext.strings} {}
+
+        SerumIndex index() const { return mIndex; }
+        const bin::Serum& record() const { return *mRecord; }
+
+        std::string name() const { return acmacs::string::concat(mVirusType, "/", mRecord->name(*mStrings)); }
+        std::string name_without_virus_type() const { return mRecord->name(*mStrings); }
+        std::string_view host() const { return mRecord->host(*mStrings); }
+        std::string_view passage() const { return mRecord->passage(*mStrings); }
+        acmacs::chart::BLineage lineage() const { return mRecord->lineage; }
+        std::string_view reassortant() const { return mRecord->reassortant(); }
+        std::vector<std::string_view> annotations() const { return mRecord->annotations(); }
+        std::string_view serum_id() const { return mRecord->serum_id(); }
+        std::string_view serum_species() const { return mRecord->serum_species(*mStrings); }
+        bin::span<bin::homologous_t> homologous_antigens() const { const auto [size, ptr] = mRecord->homologous_antigens(); return {ptr, size}; }
+
+        bin::span<bin::table_index_t> tables() const { const auto [size, ptr] = mRecord->tables(); return {ptr, size}; }
+        size_t number_of_tables() const { return mRecord->tables().first; }
+
+        std::string_view location() const { return mRecord->location(*mStrings); }
+        std::string_view isolation() const { return mRecord->isolation(); }
+        std::string year() const { return mRecord->year(); }
+
+        std::string full_name() const { return acmacs::string::concat(mVirusType, "/", mRecord->full_name(*mStrings)); }
+
+     private:
+        const bin::Serum* mRecord;
+        SerumIndex mIndex;
+        std::string_view mVirusType;
+        const bin::Strings* mStrings;
+
+    }; // class SerumRef
+
+    class TableRef
+    {
+     public:
+        using index_t = TableIndex;
+        struct context_t
+        {
+            size_t number_of_tables;
+            std::string_view titers; // numeric titers section, empty if absent
+            std::string_view dates;  // numeric table dates section, empty if absent
+            bool titers_in_index_order; // see HiDb::titers_in_index_order()
+            const bin::Strings* strings; // see HiDb::strings()
+        };
+
+        TableRef(const bin::Table& aRecord, TableIndex aIndex, const context_t& aContext)
+            : mRecord{&aRecord}, mIndex{aIndex}, mTiters{aContext.titers.empty() ? nullptr : bin::titers_of_table(aContext.titers, aContext.number_of_tables, *aIndex)},
+              mDates{aContext.dates.empty() ? nullptr : reinterpret_cast<const bin::TableDate*>(aContext.dates.data())}, mStrings{aContext.strings}, mTitersInIndexOrder{aContext.titers_in_index_order} {}
+
+        TableIndex index() const { return mIndex; }
+        const bin::Table& record() const { return *mRecord; }
+
+        std::string name() const;
+        std::string_view assay() const { return mRecord->assay(*mStrings); }
+        std::string_view lab() const { return mRecord->lab(*mStrings); }
+        std::string_view date() const { return mRecord->date(); }
+        bin::TableDate date_numeric() const { return mDates ? mDates[*mIndex] : bin::TableDate::make(date()); }
+        std::string_view rbc() const { return mRecord->rbc(*mStrings); }
+        size_t number_of_antigens() const { return mRecord->number_of_antigens(); }
+        size_t number_of_sera() const { return mRecord->number_of_sera(); }
+        bin::span<bin::antigen_index_t> antigens() const { return {mRecord->antigen_begin(), number_of_antigens()}; }
+        bin::span<bin::serum_index_t> sera() const { return {mRecord->serum_begin(), number_of_sera()}; }
+
+          // aAntigenNo, aSerumNo - positions in antigens() and sera() of this table
+          // titer accessors throw hidb::error if hidb5b titers are not in index order, see HiDb::titers_in_index_order()
+        std::string_view titer_text(size_t aAntigenNo, size_t aSerumNo) const { check_titers_in_index_order(); return mRecord->titer(aAntigenNo, aSerumNo); }
+        bin::titer_t titer_numeric(size_t aAntigenNo, size_t aSerumNo) const;
+        bool has_numeric_titers() const { return mTiters != nullptr; }
+        const bin::titer_t* numeric_titers() const { check_titers_in_index_order(); return mTiters; } // all titers of the table, antigen 0 first, nullptr if section is absent
+        void check_titers_in_index_order() const { if (!mTitersInIndexOrder) titers_not_in_index_order(); }
+
+     private:
+        const bin::Table* mRecord;
+        TableIndex mIndex;
+        const bin::titer_t* mTiters; // numeric titers of this table, nullptr if section is absent
+        const bin::TableDate* mDates; // numeric dates of all tables, nullptr if section is absent
+        const bin::Strings* mStrings;
+        bool mTitersInIndexOrder;
+
+    }; // class TableRef
+
+      // ----------------------------------------------------------------------
 
     class Antigen : public acmacs::chart::Antigen
     {
      public:
-        Antigen(const char* aAntigen, const HiDb& aHiDb) : mAntigen(aAntigen), mHiDb(aHiDb) {}
+        Antigen(const AntigenRef& aRef) : mRef{aRef} {}
 
         acmacs::virus::name_t name() const override;
         acmacs::chart::Date date() const override;
@@ -51,15 +220,13 @@ namespace hidb
 
         std::string full_name() const;
 
+        const AntigenRef& ref() const { return mRef; }
+
      private:
-        const char* mAntigen;
-        const HiDb& mHiDb;
+        AntigenRef mRef; // accessors are implemented on top of the view
 
     }; // class Antigen
 
-    using AntigenIndex = acmacs::named_size_t<struct AntigenIndex_tag>;
-    using AntigenIndexList = std::vector<AntigenIndex>;
-
     using AntigenP = std::shared_ptr<Antigen>;
     using AntigenPList = std::vector<AntigenP>;
     using AntigenPIndex = std::pair<AntigenP, AntigenIndex>;
@@ -77,13 +244,28 @@ namespace hidb
         // AntigenPIndexList find(std::string_view aName, fix_location aFixLocation, find_fuzzy fuzzy = find_fuzzy::no) const;
         AntigenIndexList find(std::string_view aName, fix_location aFixLocation, find_fuzzy fuzzy = find_fuzzy::no) const;
         AntigenPList find_labid(std::string_view labid) const;
+        AntigenIndexList find_labid_exact(std::string_view labid) const; // labid with lab prefix, e.g. CDC#2017706005, result is sorted
+        std::optional<AntigenIndex> find_full_name(std::string_view aFullName) const; // aFullName as returned by Antigen::full_name(), virus type prefix is optional
         std::optional<AntigenPIndex> find(const acmacs::chart::Antigen& aAntigen, passage_strictness aPassageStrictness = passage_strictness::yes) const;
         AntigenPList find(const acmacs::chart::Antigens& aAntigens) const; // entry* per each antigen
         AntigenPList find(const acmacs::chart::Antigens& aAntigens, const acmacs::chart::Indexes& indexes) const; // entry* per each index
+          // find(const acmacs::chart::Antigen&) for many antigens at once: chart names are parsed and sorted once, then merge-joined with the sorted antigens of hidb
+          // result has an entry per each antigen (index), same as for individual find()
+        std::vector<std::optional<AntigenIndex>> find_all(const acmacs::chart::Antigens& aAntigens, passage_strictness aPassageStrictness = passage_strictness::yes) const;
+        std::vector<std::optional<AntigenIndex>> find_all(const acmacs::chart::Antigens& aAntigens, const acmacs::chart::Indexes& indexes, passage_strictness aPassageStrictness = passage_strictness::yes) const;
+          // at most aNumber antigens closest to aName (upper case, as for find()) by edit distance of LOCATION/ISOLATION/YEAR, closest first
+          // finds misspelled locations and transposed isolation numbers, candidates are picked by the trigram index (ANTG section)
+        std::vector<similar_t<AntigenIndex>> find_similar(std::string_view aName, size_t aNumber = 10) const;
+          // at most aNumber distinct antigen names starting with aPrefix (upper case, virus type prefix is optional), most tables first, for type-ahead
+          // completions are ranked when hidb5b is made (ANCP section), antigens are not scanned
+          // aNumber is limited to bin::Completions::top_size (16), the number of completions ranked for each prefix
+        std::vector<completion_t<AntigenIndex>> complete(std::string_view aPrefix, size_t aNumber = 10) const;
         AntigenPList date_range(std::string_view first, std::string_view after_last) const;
+          // antigens with aFirst <= bin::Antigen::date_raw() < aAfterLast sorted by date, then by index, antigens without date have bin::Antigen::min_date()
+        std::pair<const bin::DatedAntigen*, const bin::DatedAntigen*> by_date(bin::date_t aFirst, bin::date_t aAfterLast) const;
 
-        std::vector<std::pair<std::string_view, const hidb::bin::Antigen*>> sorted_by_labid() const; // for seqdb-3, to speed up looking by lab_id
-        AntigenP make(const hidb::bin::Antigen* antigen_bin) const { return std::make_shared<Antigen>(reinterpret_cast<const char*>(antigen_bin), mHiDb); }
+        std::vector<std::pair<std::string_view, const hidb::bin::Antigen*>> sorted_by_labid() const; // for seqdb-3, to speed up looking by lab_id, sorted on first use
+        AntigenP make(const hidb::bin::Antigen* antigen_bin) const;
         AntigenIndex index(const hidb::bin::Antigen* antigen_bin) const;
         AntigenPList list(const AntigenIndexList& indexes) const;
 
@@ -92,6 +274,19 @@ namespace hidb
         const char* mIndex;
         const char* mAntigen0;
         const HiDb& mHiDb;
+        mutable std::vector<bin::DatedAntigen> mByDate; // for hidb5b made before date sections were introduced
+        mutable std::once_flag mByDateMade;
+        mutable std::vector<std::pair<std::string_view, const hidb::bin::Antigen*>> mSortedByLabId;
+        mutable std::once_flag mSortedByLabIdMade; // Antigens of HiDb is shared by threads (see HiDb::antigens())
+        mutable std::string mTrigramsStorage; // for hidb5b made before trigram sections were introduced
+        mutable std::once_flag mTrigramsStorageMade;
+        mutable std::string mCompletionsStorage; // for hidb5b made before completion sections were introduced
+        mutable std::once_flag mCompletionsStorageMade;
+
+        bin::TrigramIndex trigrams() const;
+        bin::Completions completions() const;
+
+        std::vector<std::optional<AntigenIndex>> find_all(const std::vector<std::shared_ptr<acmacs::chart::Antigen>>& aAntigens, passage_strictness aPassageStrictness) const;
 
     }; // class Antigens
 
@@ -102,7 +297,7 @@ namespace hidb
     class Serum : public acmacs::chart::Serum
     {
      public:
-        Serum(const char* aSerum, const HiDb& aHiDb) : mSerum(aSerum), mHiDb(aHiDb) {}
+        Serum(const SerumRef& aRef) : mRef{aRef} {}
 
         acmacs::virus::name_t name() const override;
         acmacs::virus::name_t name_without_subtype() const;
@@ -125,15 +320,13 @@ namespace hidb
 
         std::string full_name() const;
 
+        const SerumRef& ref() const { return mRef; }
+
      private:
-        const char* mSerum;
-        const HiDb& mHiDb;
+        SerumRef mRef; // accessors are implemented on top of the view
 
     }; // class Serum
 
-    using SerumIndex = acmacs::named_size_t<struct SerumIndex_tag>;
-    using SerumIndexList = std::vector<SerumIndex>;
-
     using SerumP = std::shared_ptr<Serum>;
     using SerumPList = std::vector<SerumP>;
     using SerumPIndex = std::pair<SerumP, size_t>;
@@ -152,13 +345,30 @@ namespace hidb
         std::optional<SerumPIndex> find(const acmacs::chart::Serum& aSerum) const; // find_serum_of_chart
         SerumPList find(const acmacs::chart::Sera& aSera) const; // entry* per each serum
         SerumPList find(const acmacs::chart::Sera& aSera, const acmacs::chart::Indexes& indexes) const; // entry* per each index
+          // find(const acmacs::chart::Serum&) for many sera at once, see Antigens::find_all()
+        std::vector<std::optional<SerumIndex>> find_all(const acmacs::chart::Sera& aSera) const;
+        std::vector<std::optional<SerumIndex>> find_all(const acmacs::chart::Sera& aSera, const acmacs::chart::Indexes& indexes) const;
+        std::vector<similar_t<SerumIndex>> find_similar(std::string_view aName, size_t aNumber = 10) const; // see Antigens::find_similar()
+        std::vector<completion_t<SerumIndex>> complete(std::string_view aPrefix, size_t aNumber = 10) const; // see Antigens::complete()
         SerumPList find_homologous(size_t aAntigenIndex, const Antigen& aAntigen) const; // for vaccines
+        SerumIndexList find_serum_id(std::string_view aSerumId) const; // result is sorted
+        std::optional<SerumIndex> find_full_name(std::string_view aFullName) const; // aFullName as returned by Serum::full_name(), virus type prefix is optional
+        SerumP make(const hidb::bin::Serum* serum_bin) const;
+        SerumIndex index(const hidb::bin::Serum* serum_bin) const;
 
      private:
         size_t mNumberOfSera;
         const char* mIndex;
         const char* mSerum0;
         const HiDb& mHiDb;
+        mutable std::string mTrigramsStorage; // for hidb5b made before trigram sections were introduced
+        mutable std::once_flag mTrigramsStorageMade;
+        mutable std::string mCompletionsStorage; // for hidb5b made before completion sections were introduced
+        mutable std::once_flag mCompletionsStorageMade;
+
+        bin::TrigramIndex trigrams() const;
+        bin::Completions completions() const;
+        std::vector<std::optional<SerumIndex>> find_all(const std::vector<std::shared_ptr<acmacs::chart::Serum>>& aSera) const;
 
     }; // class Sera
 
@@ -167,21 +377,38 @@ namespace hidb
     class Table // : public acmacs::chart::Table
     {
      public:
-        Table(const char* aTable) : mTable(reinterpret_cast<const bin::Table*>(aTable)) {}
+        Table(const TableRef& aRef, const bin::TableSummary* aSummary = nullptr) : mRef{aRef}, mSummary{aSummary} {}
 
         std::string name() const;
         std::string_view assay() const;
         std::string_view lab() const;
         std::string_view date() const;
+        bin::TableDate date_numeric() const { return mRef.date_numeric(); }
         std::string_view rbc() const;
         size_t number_of_antigens() const;
         size_t number_of_sera() const;
         AntigenIndexList antigens() const;
         SerumIndexList sera() const;
-        AntigenIndexList reference_antigens(const HiDb& aHidb) const;
+        AntigenIndexList reference_antigens(const HiDb& aHidb) const; // copy of aHidb.tables()->reference_antigens(index)
+
+          // aAntigenNo, aSerumNo - positions in antigens() and sera() of this table
+        acmacs::chart::Titer titer(size_t aAntigenNo, size_t aSerumNo) const;
+        std::string_view titer_text(size_t aAntigenNo, size_t aSerumNo) const;
+        bin::titer_t titer_numeric(size_t aAntigenNo, size_t aSerumNo) const;
+        std::vector<bin::titer_t> titers_of_antigen(size_t aAntigenNo) const;
+        std::vector<bin::titer_t> titers_of_serum(size_t aSerumNo) const;
+        std::vector<bin::titer_t> titers() const; // titers of antigen 0, then antigen 1, etc.
+        bool has_numeric_titers() const { return mRef.has_numeric_titers(); } // false for hidb5b made before numeric titers section was introduced, titers are parsed from text then
+          // parse text titers even if numeric titers are available (e.g. for benchmarking), in the order they are stored, i.e. antigen 0 first just if HiDb::titers_in_index_order()
+        std::vector<bin::titer_t> decode_titers(bin::titer_decoder aDecoder) const;
+        bin::TableSummary summary() const; // titer histogram, number of thresholded and missing titers, precomputed unless hidb5b is old, titer order does not matter
+
+        const bin::Table* record() const { return &mRef.record(); }
+        const TableRef& ref() const { return mRef; }
 
      private:
-        const bin::Table* mTable;
+        TableRef mRef; // accessors are implemented on top of the view
+        const bin::TableSummary* mSummary; // table summaries section entry for this table
 
     }; // class Table
 
@@ -216,26 +443,43 @@ namespace hidb
         {
             switch (ord) {
                 case oldest_first:
-                    std::sort(std::begin(tables), std::end(tables), [](const auto& t1, const auto& t2) { return t1->date() < t2->date(); });
+                    std::sort(std::begin(tables), std::end(tables), [](const auto& t1, const auto& t2) { return t1->date_numeric() < t2->date_numeric(); });
                     break;
                 case recent_first:
-                    std::sort(std::begin(tables), std::end(tables), [](const auto& t1, const auto& t2) { return t1->date() > t2->date(); });
+                    std::sort(std::begin(tables), std::end(tables), [](const auto& t1, const auto& t2) { return t1->date_numeric() > t2->date_numeric(); });
                     break;
             }
         }
     };
 
+    struct table_group_t
+    {
+        size_t group; // see Tables::group()
+        std::string_view lab;
+        std::string_view assay;
+        std::string_view rbc;
+        TableIndexList tables;
+    };
+
     class Tables // : public acmacs::chart::Tables
     {
      public:
-        Tables(TableIndex aNumberOfTables, const char* aIndex, const char* aTable0)
-            : mNumberOfTables{aNumberOfTables}, mIndex{aIndex}, mTable0{aTable0} {}
+        Tables(TableIndex aNumberOfTables, const char* aIndex, const char* aTable0, const bin::Strings& aStrings, std::string_view aTiters = {}, std::string_view aSummaries = {}, std::string_view aDates = {}, std::string_view aByDate = {},
+               std::string_view aReferenceAntigens = {}, std::string_view aGroups = {}, const char* aData = nullptr, bool aTitersInIndexOrder = false)
+            : mNumberOfTables{aNumberOfTables}, mIndex{aIndex}, mTable0{aTable0}, mStrings{&aStrings}, mTiters{aTiters}, mSummaries{aSummaries}, mDates{aDates}, mByDate{aByDate},
+              mReferenceAntigens{aReferenceAntigens}, mGroups{aGroups}, mData{aData}, mTitersInIndexOrder{aTitersInIndexOrder} {}
 
         TableIndex size() const { return mNumberOfTables; }
         std::shared_ptr<Table> at(TableIndex aIndex) const;
         std::shared_ptr<Table> operator[](TableIndex aIndex) const { return at(aIndex); }
         std::shared_ptr<Table> most_recent(const TableIndexList& aTables) const;
         std::shared_ptr<Table> oldest(const TableIndexList& aTables) const;
+        bin::TableDate date(TableIndex aIndex) const; // numeric date of the table, tables are compared by it
+          // tables with aFirst <= date < aAfterLast sorted by date, then by index
+        std::pair<const bin::DatedTable*, const bin::DatedTable*> by_date(bin::TableDate aFirst, bin::TableDate aAfterLast) const;
+          // sorted reference antigens of the table (see Table::reference_antigens), points into hidb5b data
+        std::pair<size_t, const bin::antigen_index_t*> reference_antigens(TableIndex aIndex) const;
+        TableIndex index(const Table& aTable) const;
         std::vector<TableStat> stat(const TableIndexList& aTables) const;
 
         using iterator = acmacs::iterator<Tables, std::shared_ptr<Table>, TableIndex>;
@@ -244,15 +488,116 @@ namespace hidb
 
         std::vector<lab_assay_rbc_table_t> sorted(const TableIndexList& indexes, lab_assay_rbc_table_t::sort_by_date_order order) const;
 
+          // lab/assay/rbc combination of each table, groups are numbered in the order of "lab:assay:rbc"
+        size_t number_of_groups() const { return groups().size(); }
+        size_t group(TableIndex aIndex) const { return groups().of(*aIndex); }
+          // aTables bucketed by group (in group order), tables of each group are sorted by date
+        std::vector<table_group_t> grouped(const TableIndexList& aTables, lab_assay_rbc_table_t::sort_by_date_order aOrder) const;
+
      private:
+        bin::TableGroups groups() const;
+
         TableIndex mNumberOfTables;
         const char* mIndex;
         const char* mTable0;
+        const bin::Strings* mStrings; // see HiDb::strings()
+        std::string_view mTiters; // numeric titers section, empty if absent
+        std::string_view mSummaries; // table summaries section, empty if absent
+        std::string_view mDates; // numeric table dates section, empty if absent
+        std::string_view mByDate; // tables sorted by date section, empty if absent
+        mutable std::vector<bin::DatedTable> mByDateStorage; // for hidb5b made before date sections were introduced
+        mutable std::once_flag mByDateStorageMade; // Tables of HiDb is shared by threads (see HiDb::tables())
+        std::string_view mReferenceAntigens; // reference antigens section, empty if absent
+        mutable std::string mReferenceAntigensStorage; // for hidb5b made before reference antigens section was introduced
+        mutable std::once_flag mReferenceAntigensStorageMade;
+        std::string_view mGroups; // table groups section, empty if absent
+        mutable std::string mGroupsStorage; // for hidb5b made before table groups section was introduced
+        mutable std::once_flag mGroupsStorageMade;
+        const char* mData; // whole hidb5b data
+        bool mTitersInIndexOrder; // see HiDb::titers_in_index_order()
 
     }; // class Tables
 
       // ----------------------------------------------------------------------
 
+      // random access range of views of all antigens (sera, tables), see HiDb::antigen_refs()
+    template <typename Ref, typename Rec> class RefRange
+    {
+     public:
+        using index_t = typename Ref::index_t;
+        using context_t = typename Ref::context_t;
+
+        class iterator
+        {
+         public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = Ref;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Ref;
+
+            iterator(const RefRange& aRange, size_t aNo) : range_{aRange}, no_{aNo} {}
+
+            Ref operator*() const { return range_[index_t{no_}]; }
+            Ref operator[](difference_type aOffset) const { return *(*this + aOffset); }
+
+            iterator& operator++() { ++no_; return *this; }
+            iterator operator++(int) { auto result = *this; ++no_; return result; }
+            iterator& operator--() { --no_; return *this; }
+            iterator operator--(int) { auto result = *this; --no_; return result; }
+            iterator& operator+=(difference_type aOffset) { no_ = static_cast<size_t>(static_cast<difference_type>(no_) + aOffset); return *this; }
+            iterator& operator-=(difference_type aOffset) { return operator+=(-aOffset); }
+            iterator operator+(difference_type aOffset) const { auto result = *this; return result += aOffset; }
+            iterator operator-(difference_type aOffset) const { auto result = *this; return result -= aOffset; }
+            friend iterator operator+(difference_type aOffset, const iterator& aIter) { return aIter + aOffset; }
+            difference_type operator-(const iterator& rhs) const { return static_cast<difference_type>(no_) - static_cast<difference_type>(rhs.no_); }
+
+            bool operator==(const iterator& rhs) const { return no_ == rhs.no_; }
+            bool operator!=(const iterator& rhs) const { return no_ != rhs.no_; }
+            bool operator<(const iterator& rhs) const { return no_ < rhs.no_; }
+            bool operator>(const iterator& rhs) const { return no_ > rhs.no_; }
+            bool operator<=(const iterator& rhs) const { return no_ <= rhs.no_; }
+            bool operator>=(const iterator& rhs) const { return no_ >= rhs.no_; }
+
+         private:
+            RefRange range_; // copy, range is just a few pointers
+            size_t no_;
+
+        }; // class iterator
+
+        RefRange(bin::Part<Rec> aPart, const context_t& aContext) : mPart{aPart}, mContext{aContext} {}
+
+        size_t size() const { return mPart.size(); }
+        bool empty() const { return mPart.size() == 0; }
+        Ref operator[](index_t aIndex) const { return Ref{mPart[*aIndex], aIndex, mContext}; }
+        iterator begin() const { return {*this, 0}; }
+        iterator end() const { return {*this, size()}; }
+
+     private:
+        bin::Part<Rec> mPart;
+        context_t mContext;
+
+    }; // class RefRange<Ref, Rec>
+
+    using AntigenRefs = RefRange<AntigenRef, bin::Antigen>;
+    using SerumRefs = RefRange<SerumRef, bin::Serum>;
+    using TableRefs = RefRange<TableRef, bin::Table>;
+
+    static_assert(std::is_trivially_copyable_v<AntigenRef> && std::is_trivially_copyable_v<SerumRef> && std::is_trivially_copyable_v<TableRef>);
+
+      // ----------------------------------------------------------------------
+
+    struct table_titer_t
+    {
+        TableIndex table;
+        std::string_view date;
+        bin::titer_t titer;
+    };
+
+    using table_titers_t = std::vector<table_titer_t>; // sorted by table index
+
+      // ----------------------------------------------------------------------
+
     class HiDb
     {
      public:
@@ -262,13 +607,47 @@ namespace hidb
         std::shared_ptr<Sera> sera() const;
         std::shared_ptr<Tables> tables() const;
         std::string_view virus_type() const;
+        std::string_view section(bin::section_id_t aId) const; // empty if section is absent (e.g. hidb5b made before sections were introduced)
+        const char* data() const { return mData; } // hidb5b data for direct access to bin records (see hidb-bin.hh)
+        bin::Fingerprint fingerprint() const { return bin::fingerprint(mData); }
+
+          // see bin::FormatVersion, titers can be read by table antigen and serum positions just if they are in index order
+        uint32_t format_version() const;
+        uint32_t format_flags() const;
+        bool titers_in_index_order() const { return format_version() >= bin::format_version_titers_in_index_order && (format_flags() & bin::format_flag_titers_in_chart_order) == 0; }
+        void check_titers_in_index_order() const { if (!titers_in_index_order()) titers_not_in_index_order(); }
+
+          // host, location, passage, serum species, assay, lab and rbc of records with format version 2 and later, records have ids of them (bin::Antigen::string_ids() etc.)
+          // empty for hidb5b made before, its records store these fields, accessors of bin records that take Strings handle both
+          // equal ids mean equal strings, ids compare in the same order as strings
+        const bin::Strings& strings() const { return mStrings; }
+
+          // allocation-free views of all antigens, sera and tables, see AntigenRef, SerumRef, TableRef
+        AntigenRefs antigen_refs() const { return {bin::antigens(mData), ast_context()}; }
+        SerumRefs serum_refs() const { return {bin::sera(mData), ast_context()}; }
+        ast_context_t ast_context() const { return {virus_type(), &mStrings}; }
+        TableRefs table_refs() const;
+
+          // bitmaps of antigens, sera and tables by lab, assay, rbc, lineage, year, host and passage (see hidb-bitmap.hh), made on first use
+        std::shared_ptr<BitmapIndex> bitmaps() const;
+
+          // parsed names and fixed locations looked up by Antigens::find() and Sera::find()
+        NameCache& name_cache() const { return *mNameCache; }
 
         std::string_view lab(const Antigen& aAntigen) const { return tables()->at(aAntigen.tables()[0])->lab(); }
         std::string_view lab(const Serum& aSerum) const { return tables()->at(aSerum.tables()[0])->lab(); }
+        std::string_view lab(const AntigenRef& aAntigen) const { return bin::tables(mData)[aAntigen.tables().front()].lab(mStrings); }
+        std::string_view lab(const SerumRef& aSerum) const { return bin::tables(mData)[aSerum.tables().front()].lab(mStrings); }
 
         std::vector<lab_assay_rbc_table_t> tables(const Antigen& aAntigen, lab_assay_rbc_table_t::sort_by_date_order order) const { return tables()->sorted(aAntigen.tables(), order); }
         std::vector<lab_assay_rbc_table_t> tables(const Serum& aSerum, lab_assay_rbc_table_t::sort_by_date_order order) const { return tables()->sorted(aSerum.tables(), order); }
 
+          // titers of antigen against serum in all tables where both are present
+        table_titers_t titers(AntigenIndex aAntigen, SerumIndex aSerum) const;
+          // titers of each antigen against each serum, result[antigen_no * aSera.size() + serum_no]
+          // tables of each antigen and serum and their row/column in each table are looked up just once
+        std::vector<table_titers_t> titers(const AntigenIndexList& aAntigens, const SerumIndexList& aSera) const;
+
         // void find_homologous_antigens_for_sera_of_chart(Chart& aChart) const; // sets homologous_antigen attribute in chart
         // std::string serum_date(const SerumData& aSerum) const; // for stat
 
@@ -279,9 +658,21 @@ namespace hidb
 
      private:
         const char* mData = nullptr;
-        std::string mDataStorage;
+        const bin::SectionsHeader* mSections = nullptr;
+        bin::Strings mStrings; // views of HiDb point to it, HiDb is not movable
+        struct free_aligned { void operator()(char* aData) const { std::free(aData); } };
+          // hidb5b converted from hidb5.json, aligned at cache line like a memory mapped file, sections rely on it (see doc/hidb5-bin-format.txt)
+        std::unique_ptr<char, free_aligned> mDataStorage;
+        size_t mDataStorageSize = 0;
         acmacs::file::read_access mAccess;
+        mutable std::shared_ptr<Antigens> antigens_; // made on first use, keeps caches of Antigens (e.g. sorted_by_labid())
         mutable std::shared_ptr<Tables> tables_;
+          // HiDb returned by hidb::get() is shared by threads, caches are made under once flags
+        mutable std::once_flag antigens_made_;
+        mutable std::once_flag tables_made_;
+        mutable std::shared_ptr<BitmapIndex> bitmaps_;
+        mutable std::once_flag bitmaps_made_;
+        std::unique_ptr<NameCache> mNameCache = std::make_unique<NameCache>();
 
     }; // class HiDb
 
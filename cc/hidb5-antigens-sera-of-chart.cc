@@ -37,10 +37,11 @@ int main(int argc, char* const argv[])
         const auto prefix = "    "sv;
         if (!opt.sera_only) {
             auto antigens = chart->antigens();
-            for (auto ag : *antigens) {
-                fmt::print("{}\n", ag->name_full());
-                if (const auto found = hidb.antigens()->find(*ag, opt.relaxed_passage ? hidb::passage_strictness::ignore : hidb::passage_strictness::yes); found.has_value())
-                    hidb::report_antigen(hidb, *found->first, hidb::report_tables::all, prefix);
+            const auto found_antigens = hidb.antigens()->find_all(*antigens, opt.relaxed_passage ? hidb::passage_strictness::ignore : hidb::passage_strictness::yes);
+            for (size_t ag_no = 0; ag_no < antigens->size(); ++ag_no) {
+                fmt::print("{}\n", (*antigens)[ag_no]->name_full());
+                if (const auto& found = found_antigens[ag_no]; found.has_value())
+                    hidb::report_antigen(hidb, *found, hidb::report_tables::all, prefix);
                 else
                     fmt::print("{}*not found*\n\n", prefix);
             }
@@ -48,10 +49,11 @@ int main(int argc, char* const argv[])
 
         if (!opt.antigens_only) {
             auto sera = chart->sera();
-            for (auto sr : *sera) {
-                fmt::print("{}\n", sr->name_full());
-                if (const auto found = hidb.sera()->find(*sr); found.has_value())
-                    hidb::report_serum(hidb, *found->first, hidb::report_tables::all, prefix);
+            const auto found_sera = hidb.sera()->find_all(*sera);
+            for (size_t sr_no = 0; sr_no < sera->size(); ++sr_no) {
+                fmt::print("{}\n", (*sera)[sr_no]->name_full());
+                if (const auto& found = found_sera[sr_no]; found.has_value())
+                    hidb::report_serum(hidb, *found, hidb::report_tables::all, prefix);
                 else
                     fmt::print("{}*not found*\n\n", prefix);
             }
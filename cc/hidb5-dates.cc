@@ -18,12 +18,10 @@ int main(int argc, char* const argv[])
     try {
         Options opt(argc, argv);
         hidb::HiDb hidb(opt.hidb_file, opt.verbose);
-        auto antigens = hidb.antigens();
         std::vector<std::string> dates;
         std::map<std::string, size_t> years;
-        for (size_t ag_no = 0; ag_no < antigens->size(); ++ag_no) {
-            auto antigen = antigens->at(hidb::AntigenIndex{ag_no});
-            const std::string date = antigen->date_compact().substr(0, 6);
+        for (const auto antigen : hidb.antigen_refs()) {
+            const std::string date = antigen.date_compact().substr(0, 6);
             if (!date.empty()) {
                 dates.push_back(date);
                 ++years[date.substr(0, 4)];
@@ -0,0 +1,120 @@
+#include <chrono>
+#include <random>
+
+#include "acmacs-base/argv.hh"
+#include "hidb-5/hidb.hh"
+
+// ----------------------------------------------------------------------
+
+using ranges_t = std::vector<std::pair<size_t, size_t>>;
+
+template <typename AgSr> static void lower_bound_stage(const hidb::bin::Part<AgSr>& aPart, const hidb::bin::Strings& aStrings, const std::vector<std::string_view>& aLocations, ranges_t& aRanges);
+static void tree_stage(const hidb::bin::LocationTree& aTree, const std::vector<std::string_view>& aLocations, ranges_t& aRanges);
+
+// ----------------------------------------------------------------------
+
+using namespace acmacs::argv;
+struct Options : public argv
+{
+    Options(int a_argc, const char* const a_argv[], on_error on_err = on_error::exit) : argv() { parse(a_argc, a_argv, on_err); }
+
+    option<size_t> repeat{*this, "repeat", dflt{5UL}, desc{"number of runs of each lookup method, the best time is reported"}};
+    option<bool>   sera{*this, "sera", desc{"look up sera instead of antigens"}};
+
+    argument<str> hidb_file{*this, arg_name{"hidb5.hidb5b"}, mandatory};
+};
+
+template <typename AgSr> static int benchmark(const Options& opt, const hidb::bin::Part<AgSr>& aPart, const hidb::bin::Strings& aStrings, std::string_view aTreeSection);
+
+int main(int argc, char* const argv[])
+{
+    try {
+        Options opt(argc, argv);
+        hidb::HiDb hidb(opt.hidb_file);
+        if (opt.sera)
+            return benchmark(opt, hidb::bin::sera(hidb.data()), hidb.strings(), hidb.section(hidb::bin::section::serum_location_tree));
+        else
+            return benchmark(opt, hidb::bin::antigens(hidb.data()), hidb.strings(), hidb.section(hidb::bin::section::antigen_location_tree));
+    }
+    catch (std::exception& err) {
+        fmt::print(stderr, "ERROR: {}\n", err);
+        return 1;
+    }
+}
+
+// ----------------------------------------------------------------------
+
+template <typename AgSr> int benchmark(const Options& opt, const hidb::bin::Part<AgSr>& aPart, const hidb::bin::Strings& aStrings, std::string_view aTreeSection)
+{
+    const hidb::bin::LocationTree tree{aTreeSection};
+    if (tree.empty())
+        throw std::runtime_error("hidb has no location tree section, re-make it with hidb5-convert");
+
+      // location of every record, looked up in random order
+    std::vector<std::string_view> locations(aPart.size());
+    for (size_t no = 0; no < aPart.size(); ++no)
+        locations[no] = aPart[no].location(aStrings);
+    std::shuffle(locations.begin(), locations.end(), std::mt19937{1});
+    fmt::print("lookups: {}\n", locations.size());
+
+    ranges_t expected(locations.size()), found(locations.size());
+    const auto run = [&opt, &locations](std::string_view name, auto&& func) {
+        double best = 0.0;
+        for (size_t run_no = 0; run_no < *opt.repeat; ++run_no) {
+            const auto start = std::chrono::steady_clock::now();
+            func();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            if (run_no == 0 || elapsed.count() < best)
+                best = elapsed.count();
+        }
+        fmt::print("{:<12s} {:10.6f}s  {:8.1f}ns per lookup\n", name, best, best * 1e9 / static_cast<double>(locations.size()));
+    };
+
+    run("lower_bound", [&]() { lower_bound_stage(aPart, aStrings, locations, expected); });
+    run("tree", [&]() { tree_stage(tree, locations, found); });
+
+      // tree range is by location prefix, it may include records with longer locations having the same prefix
+    size_t mismatches = 0;
+    for (size_t no = 0; no < locations.size(); ++no) {
+        if (found[no].first > expected[no].first || found[no].second < expected[no].second || (locations[no].size() < hidb::bin::LocationNode::location_size && found[no] != expected[no]))
+            ++mismatches;
+    }
+    if (mismatches) {
+        AD_ERROR("{} location tree ranges differ from lower_bound", mismatches);
+        return 1;
+    }
+    return 0;
+
+} // benchmark
+
+// ----------------------------------------------------------------------
+
+template <typename AgSr> void lower_bound_stage(const hidb::bin::Part<AgSr>& aPart, const hidb::bin::Strings& aStrings, const std::vector<std::string_view>& aLocations, ranges_t& aRanges)
+{
+      // the same as filter_by() in hidb.cc without name key sections: binary search over the offsets index dereferencing records
+    const auto* index = aPart.index();
+    const auto location = [&aPart, &aStrings](const hidb::bin::ast_offset_t& offset) { return reinterpret_cast<const AgSr*>(aPart.first() + offset)->location(aStrings); };
+    for (size_t no = 0; no < aLocations.size(); ++no) {
+        const auto look_for = aLocations[no];
+        const auto* first = std::lower_bound(index, index + aPart.size(), look_for, [&location](const auto& offset, std::string_view value) { return location(offset) < value; });
+        auto* last = first;
+        while (last != index + aPart.size() && location(*last) == look_for)
+            ++last;
+        aRanges[no] = {static_cast<size_t>(first - index), static_cast<size_t>(last - index)};
+    }
+
+} // lower_bound_stage
+
+// ----------------------------------------------------------------------
+
+void tree_stage(const hidb::bin::LocationTree& aTree, const std::vector<std::string_view>& aLocations, ranges_t& aRanges)
+{
+    for (size_t no = 0; no < aLocations.size(); ++no)
+        aRanges[no] = aTree.find(aLocations[no]);
+
+} // tree_stage
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
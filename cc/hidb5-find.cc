@@ -19,6 +19,8 @@ static void list_all_tables(const hidb::HiDb& hidb);
 static void find_antigens(const hidb::HiDb& hidb, std::string_view aName);
 static void find_antigens_by_labid(const hidb::HiDb& hidb, std::string_view aLabId);
 static void find_sera(const hidb::HiDb& hidb, std::string_view aName);
+static void find_similar(const hidb::HiDb& hidb, std::string_view aName, const Options& opt);
+static void complete(const hidb::HiDb& hidb, std::string_view aPrefix, const Options& opt);
 [[noreturn]] static void find_tables(const hidb::HiDb& hidb, std::string_view aName);
 static void find(const hidb::HiDb& hidb, const Options& opt);
 
@@ -35,6 +37,8 @@ struct Options : public argv
     option<bool> list_names{*this, "list-names", desc{"list only names without subtype"}};
     option<str>  lab{*this, "lab"};
     option<bool> find_by_lab_id{*this, "lab-id", desc{"find by lab id"}};
+    option<size_t> similar{*this, "similar", dflt{0UL}, desc{"report that many antigens (sera) with the most similar names, e.g. for misspelled names"}};
+    option<size_t> complete{*this, "complete", dflt{0UL}, desc{"report that many (at most 16) antigen (serum) names starting with the given prefix, most tables first"}};
     // option<str>  db_dir{*this, "db-dir"};
 
     argument<str> virus_type{*this, arg_name{"virus-type: B, H1, H3|hidb-file"}, mandatory};
@@ -73,7 +77,11 @@ void find(const hidb::HiDb& hidb, const Options& opt)
     }
     else {
         for (const auto& name : *opt.names) {
-            if (opt.find_sera)
+            if (opt.similar > 0UL)
+                find_similar(hidb, name, opt);
+            else if (opt.complete > 0UL)
+                complete(hidb, name, opt);
+            else if (opt.find_sera)
                 find_sera(hidb, name);
             else if (opt.find_table)
                 find_tables(hidb, name);
@@ -138,6 +146,36 @@ void find_sera(const hidb::HiDb& hidb, std::string_view aName)
 
 // ----------------------------------------------------------------------
 
+void find_similar(const hidb::HiDb& hidb, std::string_view aName, const Options& opt)
+{
+    if (opt.find_sera) {
+        for (const auto& [serum_index, distance] : hidb.sera()->find_similar(string::upper(aName), opt.similar))
+            report_serum(hidb, serum_index, hidb::report_tables::oldest, fmt::format("{:2d} ", distance));
+    }
+    else {
+        for (const auto& [antigen_index, distance] : hidb.antigens()->find_similar(string::upper(aName), opt.similar))
+            report_antigen(hidb, antigen_index, hidb::report_tables::oldest, fmt::format("{:2d} ", distance));
+    }
+
+} // find_similar
+
+// ----------------------------------------------------------------------
+
+void complete(const hidb::HiDb& hidb, std::string_view aPrefix, const Options& opt)
+{
+    const auto report = [](const auto& completions) {
+        for (const auto& completion : completions)
+            fmt::print("{:5d} {}\n", completion.number_of_tables, completion.name);
+    };
+    if (opt.find_sera)
+        report(hidb.sera()->complete(string::upper(aPrefix), opt.complete));
+    else
+        report(hidb.antigens()->complete(string::upper(aPrefix), opt.complete));
+
+} // complete
+
+// ----------------------------------------------------------------------
+
 void find_tables(const hidb::HiDb& /*hidb*/, std::string_view /*aName*/)
 {
     throw std::runtime_error("Not implemented");
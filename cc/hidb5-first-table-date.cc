@@ -34,21 +34,22 @@ int main(int argc, char* const argv[])
         std::map<std::string, std::vector<std::tuple<std::string, std::string, std::string, std::string, std::string, std::string, acmacs::virus::lineage_t>>> data;
         for (const std::string_view subtype : {"B", "H1", "H3"}) {
             auto& hidb = hidb::get(acmacs::virus::type_subtype_t{subtype}, report_time::yes);
-            auto antigens = hidb.antigens();
-            auto tables = hidb.tables();
-            for (auto ag_no = 0UL; ag_no < antigens->size(); ++ag_no) {
-                auto antigen = antigens->at(hidb::AntigenIndex{ag_no});
-                const auto date = date::from_string(antigen->date_compact());
-                const auto lineage = antigen->lineage();
-                const auto country = antigen->country(locdb);
+            const auto tables = hidb.table_refs();
+            for (const auto antigen : hidb.antigen_refs()) {
+                const auto date = date::from_string(antigen.date_compact());
+                const auto lineage = antigen.lineage();
+                const auto country = antigen.country(locdb);
                 std::string lab_id;
-                if (const auto lab_ids = antigen->lab_ids(); !lab_ids->empty())
-                    lab_id = (*lab_ids)[0];
-                auto first_table = tables->oldest(antigen->tables());
-                const auto first_table_date = first_table->date().substr(0, 8);
+                if (const auto lab_ids = antigen.lab_ids(); !lab_ids.empty())
+                    lab_id = lab_ids[0];
+                const auto antigen_tables = antigen.tables();
+                const auto first_table = tables[hidb::TableIndex{*std::min_element(antigen_tables.begin(), antigen_tables.end(), [&tables](auto t1, auto t2) {
+                    return tables[hidb::TableIndex{t1}].date_numeric() < tables[hidb::TableIndex{t2}].date_numeric();
+                })}];
+                const auto first_table_date = first_table.date().substr(0, 8);
                 const int days = date.ok() ? -1 : date::days_between_dates(date, date::from_string(first_table_date));
-                const auto tag = fmt::format("{}-{}-{}", subtype, first_table->lab(), first_table->assay());
-                data[tag].emplace_back(antigen->name(), date::display(date), first_table_date, days >= 0 ? std::to_string(days) : std::string{}, country, lab_id, acmacs::virus::lineage_t{lineage.to_string()});
+                const auto tag = fmt::format("{}-{}-{}", subtype, first_table.lab(), first_table.assay());
+                data[tag].emplace_back(antigen.name(), date::display(date), first_table_date, days >= 0 ? std::to_string(days) : std::string{}, country, lab_id, acmacs::virus::lineage_t{lineage.to_string()});
             }
         }
         for (auto [tag, entries] : data) {
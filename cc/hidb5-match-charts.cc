@@ -0,0 +1,49 @@
+#include "acmacs-base/argv.hh"
+#include "acmacs-base/timeit.hh"
+#include "hidb-5/hidb-match-charts.hh"
+
+// ----------------------------------------------------------------------
+
+using namespace acmacs::argv;
+struct Options : public argv
+{
+    Options(int a_argc, const char* const a_argv[], on_error on_err = on_error::exit) : argv() { parse(a_argc, a_argv, on_err); }
+
+    option<size_t> threads{*this, "threads", dflt{0UL}, desc{"number of threads, 0 - number of cpus"}};
+    option<bool> relaxed_passage{*this, "relaxed", desc{"ignore passage when matching antigens"}};
+    option<bool> verbose{*this, 'v', "verbose"};
+
+    argument<str> hidb_file{*this, arg_name{"hidb5.hidb5b"}, mandatory};
+    argument<str_array> charts{*this, arg_name{"chart"}, mandatory};
+};
+
+int main(int argc, char* const argv[])
+{
+    try {
+        Options opt(argc, argv);
+        hidb::HiDb hidb(opt.hidb_file, opt.verbose);
+        Timeit ti("matching charts: ", do_report_time(opt.verbose));
+        const auto matches = hidb::match_charts(hidb, *opt.charts, opt.relaxed_passage ? hidb::passage_strictness::ignore : hidb::passage_strictness::yes, opt.threads);
+        ti.report();
+        size_t failed = 0;
+        for (const auto& match : matches) {
+            if (match.error.empty())
+                fmt::print("{}  antigens: {}/{}  sera: {}/{}  import: {:.3f}s  match: {:.3f}s\n", match.filename, match.number_of_antigens_found(), match.antigens.size(), match.number_of_sera_found(),
+                           match.sera.size(), match.import_seconds, match.match_seconds);
+            else {
+                fmt::print("{}  ERROR: {}\n", match.filename, match.error);
+                ++failed;
+            }
+        }
+        return failed == 0 ? 0 : 2;
+    }
+    catch (std::exception& err) {
+        fmt::print(stderr, "ERROR: {}\n", err);
+        return 1;
+    }
+}
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
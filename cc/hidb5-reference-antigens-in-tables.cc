@@ -119,11 +119,13 @@ int main(int argc, char* const argv[])
             auto antigens = hidb.antigens();
             auto sera = hidb.sera();
 
-            for (auto table : *tables) {
+            for (hidb::TableIndex table_index{0}; table_index < tables->size(); ++table_index) {
+                auto table = tables->at(table_index);
                 if (opt.start->empty() || table->date() >= opt.start) {
                     // std::cerr << "DEBUG: table " << table->lab() << ' ' << table->date() << ' ' << table->assay() << ' ' << table->rbc() << '\n';
-                    for (auto antigen_index : table->reference_antigens(hidb)) {
-                        auto antigen = antigens->at(antigen_index);
+                    const auto [num_reference, reference] = tables->reference_antigens(table_index);
+                    for (const auto* antigen_index = reference; antigen_index != reference + num_reference; ++antigen_index) {
+                        auto antigen = antigens->at(hidb::AntigenIndex{*antigen_index});
                         records.emplace_back(virus_type, antigen->lineage(), table->lab(), table->date(), table->assay(), table->rbc(),
                                              antigen->format("{name_without_subtype}{ }{annotations}{ }{reassortant}"), antigen->date(),
                                              antigen->passage());
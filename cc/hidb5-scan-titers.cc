@@ -0,0 +1,116 @@
+#include "acmacs-base/argv.hh"
+#include "acmacs-base/string.hh"
+#include "acmacs-base/filesystem.hh"
+#include "hidb-5/hidb.hh"
+#include "hidb-5/hidb-titer-scan.hh"
+
+// ----------------------------------------------------------------------
+
+struct Options;
+
+static void scan(const hidb::HiDb& hidb, const Options& opt);
+static hidb::titer_predicate_t predicate(const Options& opt);
+static std::string titer_text(hidb::bin::titer_t titer);
+
+// ----------------------------------------------------------------------
+
+using namespace acmacs::argv;
+struct Options : public argv
+{
+    Options(int a_argc, const char* const a_argv[], on_error on_err = on_error::exit) : argv() { parse(a_argc, a_argv, on_err); }
+
+    option<bool>   sera{*this, 's', desc{"name is serum name, report antigens"}};
+    option<size_t> at_least{*this, "at-least", dflt{0UL}, desc{"titer >= value"}};
+    option<size_t> at_most{*this, "at-most", dflt{0UL}, desc{"titer <= value"}};
+    option<double> within_of_homologous{*this, "homologous-within", dflt{-1.0}, desc{"titer differs from homologous titer by at most this number of log2 steps"}};
+    option<double> below_homologous{*this, "homologous-below", dflt{-1.0}, desc{"titer is at least this number of log2 steps below homologous titer"}};
+
+    argument<str> virus_type{*this, arg_name{"virus-type: B, H1, H3|hidb-file"}, mandatory};
+    argument<str_array> names{*this, arg_name{"name"}, mandatory};
+};
+
+int main(int argc, char* const argv[])
+{
+    try {
+        Options opt(argc, argv);
+        if (fs::is_regular_file(*opt.virus_type))
+            scan(hidb::HiDb(opt.virus_type), opt);
+        else
+            scan(hidb::get(acmacs::virus::type_subtype_t{string::upper(*opt.virus_type)}, report_time::no), opt);
+        return 0;
+    }
+    catch (std::exception& err) {
+        fmt::print(stderr, "ERROR: {}\n", err);
+        return 1;
+    }
+}
+
+// ----------------------------------------------------------------------
+
+void scan(const hidb::HiDb& hidb, const Options& opt)
+{
+    const auto pred = predicate(opt);
+    auto antigens = hidb.antigens();
+    auto sera = hidb.sera();
+    auto tables = hidb.tables();
+    for (const auto& name : *opt.names) {
+        if (opt.sera) {
+            for (auto serum_index : sera->find(name, hidb::fix_location::no)) {
+                fmt::print("{}\n", sera->at(serum_index)->full_name());
+                for (const auto& match : hidb::scan_titers(hidb, serum_index, pred))
+                    fmt::print("  {:>7s}  {}  {}\n", titer_text(match.titer), tables->at(match.table)->name(), antigens->at(match.antigen)->full_name());
+            }
+        }
+        else {
+            for (auto antigen_index : antigens->find(name, hidb::fix_location::no)) {
+                fmt::print("{}\n", antigens->at(antigen_index)->full_name());
+                for (const auto& match : hidb::scan_titers(hidb, antigen_index, pred))
+                    fmt::print("  {:>7s}  {}  {}\n", titer_text(match.titer), tables->at(match.table)->name(), sera->at(match.serum)->full_name());
+            }
+        }
+    }
+
+} // scan
+
+// ----------------------------------------------------------------------
+
+hidb::titer_predicate_t predicate(const Options& opt)
+{
+    if (*opt.within_of_homologous >= 0.0)
+        return hidb::titer_predicate_t::within_of_homologous(opt.within_of_homologous);
+    if (*opt.below_homologous >= 0.0)
+        return hidb::titer_predicate_t::below_homologous(opt.below_homologous);
+    if (*opt.at_least > 0 && *opt.at_most > 0)
+        return hidb::titer_predicate_t::between(opt.at_least, opt.at_most);
+    if (*opt.at_most > 0)
+        return hidb::titer_predicate_t::at_most(opt.at_most);
+    if (*opt.at_least > 0)
+        return hidb::titer_predicate_t::at_least(opt.at_least);
+    throw std::runtime_error("no predicate, use --at-least, --at-most, --homologous-within or --homologous-below");
+
+} // predicate
+
+// ----------------------------------------------------------------------
+
+std::string titer_text(hidb::bin::titer_t titer)
+{
+    switch (titer.type()) {
+        case hidb::bin::titer_t::dont_care:
+            return "*";
+        case hidb::bin::titer_t::less_than:
+            return fmt::format("<{}", titer.value());
+        case hidb::bin::titer_t::more_than:
+            return fmt::format(">{}", titer.value());
+        case hidb::bin::titer_t::dodgy:
+            return fmt::format("~{}", titer.value());
+        case hidb::bin::titer_t::regular:
+            break;
+    }
+    return fmt::format("{}", titer.value());
+
+} // titer_text
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -0,0 +1,151 @@
+#include <random>
+#include <set>
+
+#include "acmacs-base/fmt.hh"
+#include "hidb-5/hidb-bitmap.hh"
+
+// ----------------------------------------------------------------------
+// Bitmap add, contains, size, to_vector, for_each, & and | must agree with std::set for sparse (array) and dense (bits) chunks,
+// including chunks crossing array_limit in either direction and indexes in several chunks
+// ----------------------------------------------------------------------
+
+using reference_t = std::set<uint32_t>;
+
+static reference_t make_indexes(size_t aNumber, uint32_t aMax, std::mt19937& aGenerator);
+static hidb::Bitmap make_bitmap(const reference_t& aIndexes, bool aShuffled, std::mt19937& aGenerator);
+static size_t check(std::string_view aName, const hidb::Bitmap& aBitmap, const reference_t& aExpected);
+
+// ----------------------------------------------------------------------
+
+int main()
+{
+    try {
+        std::mt19937 generator{20200302}; // fixed seed, failures are reproducible
+        size_t failures = 0, checked = 0;
+
+        const std::vector<std::pair<size_t, uint32_t>> shapes{
+            {0, 0xFFFF},                                        // empty
+            {10, 0xFFFF},                                       // single sparse chunk
+            {hidb::Bitmap::array_limit, 0xFFFF},                // at most array_limit, array chunk
+            {hidb::Bitmap::array_limit + 1, 0xFFFF},            // may cross array_limit
+            {30000, 0xFFFF},                                    // dense chunk
+            {3000, 0x3FFFF},                                    // several sparse chunks
+            {50000, 0x2FFFF},                                   // several dense chunks
+            {20000, 0xFFFFFFFF},                                // many chunks with a few indexes each
+        };
+        for (const auto& [number1, max1] : shapes) {
+            for (const auto& [number2, max2] : shapes) {
+                const auto indexes1 = make_indexes(number1, max1, generator), indexes2 = make_indexes(number2, max2, generator);
+                const auto bitmap1 = make_bitmap(indexes1, false, generator), bitmap2 = make_bitmap(indexes2, true, generator);
+                failures += check("increasing add", bitmap1, indexes1);
+                failures += check("shuffled add", bitmap2, indexes2);
+
+                reference_t intersection, union_of{indexes1};
+                std::set_intersection(indexes1.begin(), indexes1.end(), indexes2.begin(), indexes2.end(), std::inserter(intersection, intersection.end()));
+                union_of.insert(indexes2.begin(), indexes2.end());
+                failures += check("&", bitmap1 & bitmap2, intersection);
+                failures += check("|", bitmap1 | bitmap2, union_of);
+                failures += check("& self", bitmap1 & bitmap1, indexes1);
+                failures += check("| self", bitmap2 | bitmap2, indexes2);
+                auto in_place = bitmap1;
+                in_place &= bitmap2;
+                in_place |= bitmap2;
+                failures += check("&= |=", in_place, indexes2);
+                checked += 7;
+            }
+        }
+
+          // dense chunk becomes sparse after intersection, sparse chunks become dense after union
+        reference_t evens, odds, low_evens;
+        for (uint32_t index = 0; index < 0x10000; ++index) {
+            (index % 2 ? odds : evens).insert(index);
+            if (index % 2 == 0 && index < 2 * hidb::Bitmap::array_limit)
+                low_evens.insert(index);
+        }
+        const auto bitmap_evens = make_bitmap(evens, false, generator), bitmap_odds = make_bitmap(odds, false, generator), bitmap_low_evens = make_bitmap(low_evens, false, generator);
+        reference_t all{evens};
+        all.insert(odds.begin(), odds.end());
+        failures += check("dense & disjoint dense", bitmap_evens & bitmap_odds, {});
+        failures += check("dense & sparse", bitmap_evens & bitmap_low_evens, low_evens);
+        failures += check("dense | dense", bitmap_evens | bitmap_odds, all);
+        checked += 3;
+
+        if (failures) {
+            fmt::print(stderr, "ERROR: bitmap: {} of {} checks failed\n", failures, checked);
+            return 1;
+        }
+        fmt::print("bitmap: {} checks against std::set passed\n", checked);
+        return 0;
+    }
+    catch (std::exception& err) {
+        fmt::print(stderr, "ERROR: {}\n", err);
+        return 1;
+    }
+}
+
+// ----------------------------------------------------------------------
+
+reference_t make_indexes(size_t aNumber, uint32_t aMax, std::mt19937& aGenerator)
+{
+    reference_t indexes;
+    std::uniform_int_distribution<uint32_t> index_of(0, aMax);
+    while (indexes.size() < std::min(aNumber, static_cast<size_t>(aMax) + 1))
+        indexes.insert(index_of(aGenerator));
+    return indexes;
+
+} // make_indexes
+
+// ----------------------------------------------------------------------
+
+hidb::Bitmap make_bitmap(const reference_t& aIndexes, bool aShuffled, std::mt19937& aGenerator)
+{
+    std::vector<uint32_t> indexes(aIndexes.begin(), aIndexes.end());
+    if (aShuffled)
+        std::shuffle(indexes.begin(), indexes.end(), aGenerator);
+    hidb::Bitmap bitmap;
+    for (const auto index : indexes) {
+        bitmap.add(index);
+        bitmap.add(index); // adding twice changes nothing
+    }
+    return bitmap;
+
+} // make_bitmap
+
+// ----------------------------------------------------------------------
+
+size_t check(std::string_view aName, const hidb::Bitmap& aBitmap, const reference_t& aExpected)
+{
+    size_t failures = 0;
+    auto report = [aName, &failures](std::string_view aMessage) {
+        if (failures++ == 0)
+            fmt::print(stderr, "{}: {}\n", aName, aMessage);
+    };
+
+    if (aBitmap.size() != aExpected.size())
+        report(fmt::format("size {}, expected {}", aBitmap.size(), aExpected.size()));
+    if (aBitmap.empty() != aExpected.empty())
+        report("empty() differs");
+    if (const auto vec = aBitmap.to_vector(); !std::equal(vec.begin(), vec.end(), aExpected.begin(), aExpected.end()))
+        report("to_vector() differs");
+    std::vector<uint32_t> visited;
+    aBitmap.for_each([&visited](uint32_t index) { visited.push_back(index); });
+    if (!std::equal(visited.begin(), visited.end(), aExpected.begin(), aExpected.end()))
+        report("for_each() differs");
+    for (const auto index : aExpected) {
+        if (!aBitmap.contains(index)) {
+            report(fmt::format("{} not found", index));
+            break;
+        }
+    }
+    for (const auto index : {0U, 1U, 4095U, 4096U, 0xFFFFU, 0x10000U, 0x12345U, 0xFFFFFFFFU}) {
+        if (aBitmap.contains(index) != (aExpected.count(index) > 0))
+            report(fmt::format("contains({}) differs", index));
+    }
+    return failures > 0 ? 1 : 0;
+
+} // check
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
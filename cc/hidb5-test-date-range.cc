@@ -0,0 +1,149 @@
+#include <set>
+#include <algorithm>
+#include <iterator>
+
+#include "acmacs-base/fmt.hh"
+#include "hidb-5/hidb.hh"
+
+// ----------------------------------------------------------------------
+// Antigens::by_date, Antigens::date_range and Tables::by_date must return the same antigens (tables) in the same order
+// as a linear scan for windows starting and ending at, before and after every date present
+// ----------------------------------------------------------------------
+
+template <typename Date> static std::vector<Date> boundaries(const std::set<Date>& aDates, Date aMin, Date aMax);
+static size_t check_antigens(const hidb::HiDb& aHiDb, size_t& aChecked);
+static size_t check_tables(const hidb::HiDb& aHiDb, size_t& aChecked);
+
+// ----------------------------------------------------------------------
+
+int main(int argc, char* const argv[])
+{
+    try {
+        if (argc != 2)
+            throw std::runtime_error(fmt::format("Usage: {} <hidb5.hidb5b|hidb5.json.xz>", argv[0]));
+        hidb::HiDb hidb(argv[1]);
+        size_t checked = 0;
+        const auto failures = check_antigens(hidb, checked) + check_tables(hidb, checked);
+        if (failures) {
+            fmt::print(stderr, "ERROR: date range: {} of {} windows differ from linear scan\n", failures, checked);
+            return 1;
+        }
+        fmt::print("date range: {} windows found as linear scan does\n", checked);
+        return 0;
+    }
+    catch (std::exception& err) {
+        fmt::print(stderr, "ERROR: {}\n", err);
+        return 1;
+    }
+}
+
+// ----------------------------------------------------------------------
+
+  // every date present, the dates next to them and the extremes, at most about 64 of them to keep the number of windows low
+template <typename Date> std::vector<Date> boundaries(const std::set<Date>& aDates, Date aMin, Date aMax)
+{
+    std::set<Date> all{aMin, aMax};
+    const size_t step = aDates.size() / 21 + 1;
+    size_t no = 0;
+    for (const auto date : aDates) {
+        if (no++ % step == 0) {
+            all.insert(date);
+            if constexpr (std::is_same_v<Date, hidb::bin::TableDate>) {
+                all.insert(hidb::bin::TableDate{date.date, date.sequence + 1});
+                all.insert(hidb::bin::TableDate{date.date + 1, 0});
+            }
+            else
+                all.insert(date + 1);
+        }
+    }
+    return {all.begin(), all.end()};
+
+} // boundaries
+
+// ----------------------------------------------------------------------
+
+size_t check_antigens(const hidb::HiDb& aHiDb, size_t& aChecked)
+{
+    const auto part = hidb::bin::antigens(aHiDb.data());
+    std::vector<hidb::bin::DatedAntigen> all(part.size());
+    std::set<hidb::bin::date_t> dates;
+    for (size_t no = 0; no < part.size(); ++no) {
+        all[no] = hidb::bin::DatedAntigen{part[no].date_raw(), static_cast<hidb::bin::antigen_index_t>(no)};
+        dates.insert(all[no].date);
+    }
+    std::sort(all.begin(), all.end(), [](const auto& e1, const auto& e2) { return e1.date == e2.date ? e1.antigen < e2.antigen : e1.date < e2.date; });
+
+    const auto antigens = aHiDb.antigens();
+    const auto bounds = boundaries(dates, hidb::bin::Antigen::min_date(), hidb::bin::Antigen::max_date());
+    size_t failures = 0;
+    for (auto first = bounds.begin(); first != bounds.end(); ++first) {
+        for (auto after_last = first; after_last != bounds.end(); ++after_last) {
+            std::vector<hidb::bin::DatedAntigen> expected;
+            std::copy_if(all.begin(), all.end(), std::back_inserter(expected), [&](const auto& entry) { return *first <= entry.date && entry.date < *after_last; });
+            const auto [begin, end] = antigens->by_date(*first, *after_last);
+            if (!std::equal(begin, end, expected.begin(), expected.end(), [](const auto& e1, const auto& e2) { return e1.date == e2.date && e1.antigen == e2.antigen; })) {
+                if (failures < 10)
+                    fmt::print(stderr, "antigens by_date [{}, {}): {} found, expected {}\n", *first, *after_last, end - begin, expected.size());
+                ++failures;
+            }
+
+              // date_range returns the same antigens in the order of antigens
+            std::vector<size_t> expected_indexes(expected.size()), found_indexes;
+            std::transform(expected.begin(), expected.end(), expected_indexes.begin(), [](const auto& entry) { return static_cast<size_t>(entry.antigen); });
+            std::sort(expected_indexes.begin(), expected_indexes.end());
+            for (const auto& antigen : antigens->date_range(std::to_string(*first), std::to_string(*after_last)))
+                found_indexes.push_back(*antigen->ref().index());
+            if (found_indexes != expected_indexes) {
+                if (failures < 10)
+                    fmt::print(stderr, "antigens date_range [{}, {}): {} found, expected {}\n", *first, *after_last, found_indexes.size(), expected_indexes.size());
+                ++failures;
+            }
+            aChecked += 2;
+        }
+    }
+    return failures;
+
+} // check_antigens
+
+// ----------------------------------------------------------------------
+
+size_t check_tables(const hidb::HiDb& aHiDb, size_t& aChecked)
+{
+    const auto part = hidb::bin::tables(aHiDb.data());
+    const auto tables = aHiDb.tables();
+    size_t failures = 0;
+
+    std::vector<hidb::bin::DatedTable> all(part.size());
+    std::set<hidb::bin::TableDate> dates;
+    for (size_t no = 0; no < part.size(); ++no) {
+        all[no] = hidb::bin::DatedTable{hidb::bin::TableDate::make(part[no].date()), static_cast<hidb::bin::table_index_t>(no)};
+        dates.insert(all[no].date);
+        if (const auto date = tables->date(hidb::TableIndex{no}); date != all[no].date) {
+            fmt::print(stderr, "table {} \"{}\": date {}.{}, expected {}.{}\n", no, part[no].date(), date.date, date.sequence, all[no].date.date, all[no].date.sequence);
+            ++failures;
+        }
+    }
+    std::sort(all.begin(), all.end(), [](const auto& e1, const auto& e2) { return e1.date == e2.date ? e1.table < e2.table : e1.date < e2.date; });
+
+    const auto bounds = boundaries(dates, hidb::bin::TableDate{0, 0}, hidb::bin::TableDate{hidb::bin::Antigen::max_date(), 0});
+    for (auto first = bounds.begin(); first != bounds.end(); ++first) {
+        for (auto after_last = first; after_last != bounds.end(); ++after_last) {
+            std::vector<hidb::bin::DatedTable> expected;
+            std::copy_if(all.begin(), all.end(), std::back_inserter(expected), [&](const auto& entry) { return !(entry.date < *first) && entry.date < *after_last; });
+            const auto [begin, end] = tables->by_date(*first, *after_last);
+            if (!std::equal(begin, end, expected.begin(), expected.end(), [](const auto& e1, const auto& e2) { return e1.date == e2.date && e1.table == e2.table; })) {
+                if (failures < 10)
+                    fmt::print(stderr, "tables by_date [{}.{}, {}.{}): {} found, expected {}\n", first->date, first->sequence, after_last->date, after_last->sequence, end - begin, expected.size());
+                ++failures;
+            }
+            ++aChecked;
+        }
+    }
+    return failures;
+
+} // check_tables
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
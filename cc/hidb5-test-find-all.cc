@@ -0,0 +1,133 @@
+#include "acmacs-base/fmt.hh"
+#include "acmacs-chart-2/factory-import.hh"
+#include "acmacs-chart-2/chart.hh"
+#include "hidb-5/hidb.hh"
+
+// ----------------------------------------------------------------------
+// Antigens::find_all and Sera::find_all must find the same hidb antigens (sera) as find() for each chart antigen (serum),
+// for every passage strictness and for a subset of chart indexes in another order
+// ----------------------------------------------------------------------
+
+static size_t check_antigens(const hidb::HiDb& aHiDb, const acmacs::chart::Antigens& aAntigens, size_t& aChecked);
+static size_t check_sera(const hidb::HiDb& aHiDb, const acmacs::chart::Sera& aSera, size_t& aChecked);
+static acmacs::chart::Indexes reversed_odd(size_t aNumber);
+
+// ----------------------------------------------------------------------
+
+int main(int argc, char* const argv[])
+{
+    try {
+        if (argc < 3)
+            throw std::runtime_error(fmt::format("Usage: {} <hidb5.hidb5b|hidb5.json.xz> <chart> ...", argv[0]));
+        hidb::HiDb hidb(argv[1]);
+        size_t failures = 0, checked = 0;
+        for (int arg = 2; arg < argc; ++arg) {
+            auto chart = acmacs::chart::import_from_file(argv[arg]);
+            failures += check_antigens(hidb, *chart->antigens(), checked) + check_sera(hidb, *chart->sera(), checked);
+        }
+        if (failures) {
+            fmt::print(stderr, "ERROR: find_all: {} of {} antigens and sera found differently by find()\n", failures, checked);
+            return 1;
+        }
+        fmt::print("find_all: {} antigens and sera found as find() does\n", checked);
+        return 0;
+    }
+    catch (std::exception& err) {
+        fmt::print(stderr, "ERROR: {}\n", err);
+        return 1;
+    }
+}
+
+// ----------------------------------------------------------------------
+
+acmacs::chart::Indexes reversed_odd(size_t aNumber)
+{
+    acmacs::chart::Indexes indexes;
+    for (size_t no = aNumber; no > 0; --no) {
+        if ((no - 1) % 2)
+            indexes.push_back(no - 1);
+    }
+    return indexes;
+
+} // reversed_odd
+
+// ----------------------------------------------------------------------
+
+size_t check_antigens(const hidb::HiDb& aHiDb, const acmacs::chart::Antigens& aAntigens, size_t& aChecked)
+{
+    const auto antigens = aHiDb.antigens();
+    size_t failures = 0;
+    for (auto strictness : {hidb::passage_strictness::yes, hidb::passage_strictness::ignore_if_empty, hidb::passage_strictness::ignore}) {
+        std::vector<std::optional<hidb::AntigenIndex>> expected(aAntigens.size());
+        for (size_t ag_no = 0; ag_no < aAntigens.size(); ++ag_no) {
+            if (const auto found = antigens->find(*aAntigens[ag_no], strictness); found.has_value())
+                expected[ag_no] = found->second;
+        }
+        const auto report = [&failures](std::string_view aWhat, size_t ag_no, const acmacs::chart::Antigen& aAntigen) {
+            if (failures++ < 10)
+                fmt::print(stderr, "antigen {} {} ({}): found differently\n", ag_no, aAntigen.name_full(), aWhat);
+        };
+
+        const auto all = antigens->find_all(aAntigens, strictness);
+        if (all.size() != aAntigens.size())
+            throw std::runtime_error(fmt::format("find_all returned {} entries for {} antigens", all.size(), aAntigens.size()));
+        for (size_t ag_no = 0; ag_no < aAntigens.size(); ++ag_no) {
+            if (all[ag_no] != expected[ag_no])
+                report("all", ag_no, *aAntigens[ag_no]);
+        }
+
+        const auto indexes = reversed_odd(aAntigens.size());
+        const auto some = antigens->find_all(aAntigens, indexes, strictness);
+        if (some.size() != indexes.size())
+            throw std::runtime_error(fmt::format("find_all returned {} entries for {} indexes", some.size(), indexes.size()));
+        for (size_t no = 0; no < indexes.size(); ++no) {
+            if (some[no] != expected[indexes[no]])
+                report("indexes", indexes[no], *aAntigens[indexes[no]]);
+        }
+        aChecked += all.size() + some.size();
+    }
+    return failures;
+
+} // check_antigens
+
+// ----------------------------------------------------------------------
+
+size_t check_sera(const hidb::HiDb& aHiDb, const acmacs::chart::Sera& aSera, size_t& aChecked)
+{
+    const auto sera = aHiDb.sera();
+    size_t failures = 0;
+    std::vector<std::optional<hidb::SerumIndex>> expected(aSera.size());
+    for (size_t sr_no = 0; sr_no < aSera.size(); ++sr_no) {
+        if (const auto found = sera->find(*aSera[sr_no]); found.has_value())
+            expected[sr_no] = hidb::SerumIndex{found->second};
+    }
+    const auto report = [&failures](std::string_view aWhat, size_t sr_no, const acmacs::chart::Serum& aSerum) {
+        if (failures++ < 10)
+            fmt::print(stderr, "serum {} {} ({}): found differently\n", sr_no, aSerum.name_full(), aWhat);
+    };
+
+    const auto all = sera->find_all(aSera);
+    if (all.size() != aSera.size())
+        throw std::runtime_error(fmt::format("find_all returned {} entries for {} sera", all.size(), aSera.size()));
+    for (size_t sr_no = 0; sr_no < aSera.size(); ++sr_no) {
+        if (all[sr_no] != expected[sr_no])
+            report("all", sr_no, *aSera[sr_no]);
+    }
+
+    const auto indexes = reversed_odd(aSera.size());
+    const auto some = sera->find_all(aSera, indexes);
+    if (some.size() != indexes.size())
+        throw std::runtime_error(fmt::format("find_all returned {} entries for {} indexes", some.size(), indexes.size()));
+    for (size_t no = 0; no < indexes.size(); ++no) {
+        if (some[no] != expected[indexes[no]])
+            report("indexes", indexes[no], *aSera[indexes[no]]);
+    }
+    aChecked += all.size() + some.size();
+    return failures;
+
+} // check_sera
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -0,0 +1,109 @@
+#include <set>
+#include <cstring>
+
+#include "acmacs-base/fmt.hh"
+#include "hidb-5/hidb.hh"
+
+// ----------------------------------------------------------------------
+// LocationTree::find over ANLT and SRLT sections must return the same range as a linear scan of the antigens (sera) part
+// for every location present and for locations absent, shorter, longer and sharing the truncated 24 char prefix
+// ----------------------------------------------------------------------
+
+template <typename AgSr> static size_t check(std::string_view aName, const hidb::bin::Part<AgSr>& aPart, const hidb::bin::Strings& aStrings, std::string_view aTreeSection, size_t& aChecked);
+template <typename AgSr> static std::pair<size_t, size_t> scan(const hidb::bin::Part<AgSr>& aPart, const hidb::bin::Strings& aStrings, std::string_view aLocation);
+
+// ----------------------------------------------------------------------
+
+int main(int argc, char* const argv[])
+{
+    try {
+        if (argc != 2)
+            throw std::runtime_error(fmt::format("Usage: {} <hidb5.hidb5b|hidb5.json.xz>", argv[0]));
+        hidb::HiDb hidb(argv[1]);
+        size_t checked = 0;
+        const auto failures = check("antigens", hidb::bin::antigens(hidb.data()), hidb.strings(), hidb.section(hidb::bin::section::antigen_location_tree), checked)
+                + check("sera", hidb::bin::sera(hidb.data()), hidb.strings(), hidb.section(hidb::bin::section::serum_location_tree), checked);
+        if (failures) {
+            fmt::print(stderr, "ERROR: location tree: {} of {} lookups differ from linear scan\n", failures, checked);
+            return 1;
+        }
+        fmt::print("location tree: {} lookups found as linear scan does\n", checked);
+        return 0;
+    }
+    catch (std::exception& err) {
+        fmt::print(stderr, "ERROR: {}\n", err);
+        return 1;
+    }
+}
+
+// ----------------------------------------------------------------------
+
+template <typename AgSr> size_t check(std::string_view aName, const hidb::bin::Part<AgSr>& aPart, const hidb::bin::Strings& aStrings, std::string_view aTreeSection, size_t& aChecked)
+{
+    const hidb::bin::LocationTree tree{aTreeSection};
+    if (tree.empty()) {
+        if (aPart.size() == 0)
+            return 0;
+        fmt::print(stderr, "{}: no location tree section\n", aName);
+        return 1;
+    }
+
+    std::set<std::string> probes{"", "~", "A", "ZZZZZZZZZZZZZZZZZZZZZZZZZZZZ", std::string(hidb::bin::LocationNode::location_size + 3, 'A')};
+    for (size_t no = 0; no < aPart.size(); ++no) {
+        const std::string location{aPart[no].location(aStrings)};
+        probes.insert(location);
+        probes.insert(location + "A");                                                      // longer, absent unless it is truncated
+        probes.insert(location + std::string(hidb::bin::LocationNode::location_size, 'Z')); // same truncated prefix for long locations
+        if (!location.empty()) {
+            probes.insert(location.substr(0, location.size() - 1)); // shorter
+            auto next = location;
+            ++next.back();                                        // between this and the next location
+            probes.insert(next);
+        }
+    }
+
+    size_t failures = 0;
+    for (const auto& probe : probes) {
+        if (const auto found = tree.find(probe), expected = scan(aPart, aStrings, probe); found != expected) {
+            if (failures < 10)
+                fmt::print(stderr, "{}: \"{}\" found [{}, {}), expected [{}, {})\n", aName, probe, found.first, found.second, expected.first, expected.second);
+            ++failures;
+        }
+    }
+    aChecked += probes.size();
+    return failures;
+
+} // check
+
+// ----------------------------------------------------------------------
+
+  // records having the same zero padded (truncated) location prefix, {0, 0} if none, records having it must be adjacent
+template <typename AgSr> std::pair<size_t, size_t> scan(const hidb::bin::Part<AgSr>& aPart, const hidb::bin::Strings& aStrings, std::string_view aLocation)
+{
+    const auto prefix = [](std::string_view location) {
+        std::string result(hidb::bin::LocationNode::location_size, '\0');
+        std::memmove(result.data(), location.data(), std::min(location.size(), result.size()));
+        return result;
+    };
+
+    const auto look_for = prefix(aLocation);
+    size_t first = aPart.size(), last = 0, number = 0;
+    for (size_t no = 0; no < aPart.size(); ++no) {
+        if (prefix(aPart[no].location(aStrings)) == look_for) {
+            first = std::min(first, no);
+            last = no + 1;
+            ++number;
+        }
+    }
+    if (number == 0)
+        return {0, 0};
+    if (number != last - first)
+        throw std::runtime_error(fmt::format("records with location prefix \"{}\" are not adjacent", aLocation));
+    return {first, last};
+
+} // scan
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -0,0 +1,122 @@
+#include <random>
+
+#include "acmacs-base/fmt.hh"
+#include "hidb-5/hidb-titer-decoder.hh"
+
+// ----------------------------------------------------------------------
+// scalar, sse2 and avx2 titer decoders must agree with titer_t::make() for any text, including invalid titers,
+// titer lengths up to 8 are decoded by vector decoders, longer ones are decoded by scalar decoder
+// ----------------------------------------------------------------------
+
+static std::vector<std::string> make_titers(size_t aMaxLength, std::mt19937& aGenerator);
+static size_t check(const std::vector<std::string>& aTiters, size_t aMaxLength);
+
+// ----------------------------------------------------------------------
+
+int main()
+{
+    try {
+        std::mt19937 generator{20200301}; // fixed seed, failures are reproducible
+        size_t failures = 0, checked = 0;
+        for (size_t max_length = 1; max_length <= 12; ++max_length) {
+            for (size_t run = 0; run < 20; ++run) {
+                const auto titers = make_titers(max_length, generator);
+                failures += check(titers, max_length);
+                checked += titers.size();
+            }
+        }
+        if (failures) {
+            fmt::print(stderr, "ERROR: titer decoders: {} of {} titers differ from titer_t::make\n", failures, checked);
+            return 1;
+        }
+        std::string decoders;
+        for (auto decoder : {hidb::bin::titer_decoder::scalar, hidb::bin::titer_decoder::sse2, hidb::bin::titer_decoder::avx2}) {
+            if (hidb::bin::available(decoder))
+                decoders += fmt::format(" {}", hidb::bin::to_string(decoder));
+        }
+        fmt::print("titer decoders{}: {} titers decoded as titer_t::make does\n", decoders, checked);
+        return 0;
+    }
+    catch (std::exception& err) {
+        fmt::print(stderr, "ERROR: {}\n", err);
+        return 1;
+    }
+}
+
+// ----------------------------------------------------------------------
+
+std::vector<std::string> make_titers(size_t aMaxLength, std::mt19937& aGenerator)
+{
+    std::vector<std::string> titers;
+
+      // all valid titers and prefixes that fit
+    for (const auto* prefix : {"", "<", ">", "~"}) {
+        for (size_t value = 5; value <= 100'000'000; value *= 2) {
+            if (const auto titer = fmt::format("{}{}", prefix, value); titer.size() <= aMaxLength)
+                titers.push_back(titer);
+        }
+    }
+    for (const auto* special : {"", "*", "<", "~", "0", "00", "<0", ">05", "1*", "*1", "x", "4O", "1 0", "-10", "+10"}) {
+        if (std::string_view{special}.size() <= aMaxLength)
+            titers.push_back(special);
+    }
+
+      // random texts, mostly digits
+    constexpr const std::string_view alphabet{"0123456789012345678901234567890123456789<>~*x /:"};
+    std::uniform_int_distribution<size_t> length_of(0, aMaxLength), char_of(0, alphabet.size() - 1);
+    for (size_t no = 0; no < 997; ++no) { // odd number of titers, vector decoders have tails
+        std::string titer(length_of(aGenerator), ' ');
+        for (auto& cc : titer)
+            cc = alphabet[char_of(aGenerator)];
+        titers.push_back(titer);
+    }
+
+    std::shuffle(titers.begin(), titers.end(), aGenerator);
+    return titers;
+
+} // make_titers
+
+// ----------------------------------------------------------------------
+
+size_t check(const std::vector<std::string>& aTiters, size_t aMaxLength)
+{
+      // table titer block: aMaxLength bytes per titer, zero padded, nothing after the last titer
+    std::string source(aTiters.size() * aMaxLength, '\0');
+    std::vector<hidb::bin::titer_t> expected(aTiters.size());
+    size_t expected_invalid = 0;
+    for (size_t no = 0; no < aTiters.size(); ++no) {
+        std::copy(aTiters[no].begin(), aTiters[no].end(), source.begin() + static_cast<std::ptrdiff_t>(no * aMaxLength));
+        try {
+            expected[no] = hidb::bin::titer_t::make(aTiters[no]);
+        }
+        catch (hidb::bin::invalid_titer&) {
+            expected[no] = hidb::bin::titer_t{};
+            if (aTiters[no].front() != '*') // decoders do not look beyond *
+                ++expected_invalid;
+        }
+    }
+
+    size_t failures = 0;
+    for (auto decoder : {hidb::bin::titer_decoder::scalar, hidb::bin::titer_decoder::sse2, hidb::bin::titer_decoder::avx2}) {
+        if (!hidb::bin::available(decoder))
+            continue;
+        std::vector<hidb::bin::titer_t> decoded(aTiters.size());
+        if (const auto invalid = hidb::bin::decode_titers(source.data(), aMaxLength, aTiters.size(), decoded.data(), decoder); invalid != expected_invalid) {
+            fmt::print(stderr, "{} decoder, max length {}: {} invalid titers, expected {}\n", hidb::bin::to_string(decoder), aMaxLength, invalid, expected_invalid);
+            ++failures;
+        }
+        for (size_t no = 0; no < aTiters.size(); ++no) {
+            if (decoded[no] != expected[no]) {
+                fmt::print(stderr, "{} decoder, max length {}: \"{}\" decoded as {:04x}, expected {:04x}\n", hidb::bin::to_string(decoder), aMaxLength, aTiters[no], decoded[no].data, expected[no].data);
+                ++failures;
+            }
+        }
+    }
+    return failures;
+
+} // check
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -0,0 +1,114 @@
+#include <tuple>
+#include <algorithm>
+
+#include "acmacs-base/fmt.hh"
+#include "hidb-5/hidb-titers-csr.hh"
+
+// ----------------------------------------------------------------------
+// TitersCSR made with one and several threads, for all tables and for a subset of them, and read back from the saved file
+// must list the same (serum, table, titer) in each antigen row as walking the tables one by one does
+// ----------------------------------------------------------------------
+
+using entry_t = std::tuple<size_t, size_t, hidb::bin::titer_t>; // serum, table, titer
+using rows_t = std::vector<std::vector<entry_t>>;
+
+static rows_t expected_rows(const hidb::HiDb& aHiDb, const hidb::TableIndexList& aTables);
+static size_t check(std::string_view aName, const hidb::HiDb& aHiDb, const hidb::TitersCSR& aCSR, const rows_t& aExpected);
+
+// ----------------------------------------------------------------------
+
+int main(int argc, char* const argv[])
+{
+    try {
+        if (argc != 3)
+            throw std::runtime_error(fmt::format("Usage: {} <hidb5.hidb5b|hidb5.json.xz> <temp-output.hidb5csr>", argv[0]));
+        hidb::HiDb hidb(argv[1]);
+
+        hidb::TableIndexList all_tables, some_tables;
+        for (size_t table_no = 0; table_no < *hidb.tables()->size(); ++table_no) {
+            all_tables.emplace_back(table_no);
+            if (table_no % 2)
+                some_tables.emplace_back(table_no);
+        }
+        const auto all_rows = expected_rows(hidb, all_tables), some_rows = expected_rows(hidb, some_tables);
+
+        size_t failures = 0;
+        const hidb::TitersCSR csr_1(hidb, 1), csr_4(hidb, 4), csr_some(hidb, some_tables, 3);
+        failures += check("all tables, 1 thread", hidb, csr_1, all_rows);
+        failures += check("all tables, 4 threads", hidb, csr_4, all_rows);
+        failures += check("odd tables, 3 threads", hidb, csr_some, some_rows);
+        csr_4.save(argv[2]);
+        failures += check("read from file", hidb, hidb::TitersCSR(argv[2], hidb), all_rows);
+
+        if (failures) {
+            fmt::print(stderr, "ERROR: titers csr: {} of 4 checks failed\n", failures);
+            return 1;
+        }
+        fmt::print("titers csr: {} titers stored as tables have them\n", csr_1.number_of_titers());
+        return 0;
+    }
+    catch (std::exception& err) {
+        fmt::print(stderr, "ERROR: {}\n", err);
+        return 1;
+    }
+}
+
+// ----------------------------------------------------------------------
+
+  // titers of each antigen in the order of tables, then sorted by serum keeping the table order
+rows_t expected_rows(const hidb::HiDb& aHiDb, const hidb::TableIndexList& aTables)
+{
+    rows_t rows(aHiDb.antigens()->size());
+    for (const auto table_index : aTables) {
+        const auto table = aHiDb.tables()->at(table_index);
+        const auto antigens = table->antigens();
+        const auto sera = table->sera();
+        for (size_t ag_no = 0; ag_no < antigens.size(); ++ag_no) {
+            for (size_t sr_no = 0; sr_no < sera.size(); ++sr_no) {
+                if (const auto titer = table->titer_numeric(ag_no, sr_no); !titer.is_dont_care())
+                    rows[*antigens[ag_no]].emplace_back(*sera[sr_no], *table_index, titer);
+            }
+        }
+    }
+    for (auto& row : rows)
+        std::stable_sort(row.begin(), row.end(), [](const auto& e1, const auto& e2) { return std::get<0>(e1) < std::get<0>(e2); });
+    return rows;
+
+} // expected_rows
+
+// ----------------------------------------------------------------------
+
+size_t check(std::string_view aName, const hidb::HiDb& aHiDb, const hidb::TitersCSR& aCSR, const rows_t& aExpected)
+{
+    if (aCSR.number_of_antigens() != aExpected.size() || aCSR.number_of_sera() != aHiDb.sera()->size() || aCSR.number_of_tables() != *aHiDb.tables()->size() || aCSR.virus_type() != aHiDb.virus_type()) {
+        fmt::print(stderr, "{}: header differs from hidb\n", aName);
+        return 1;
+    }
+    size_t expected_titers = 0;
+    for (const auto& row : aExpected)
+        expected_titers += row.size();
+    if (aCSR.number_of_titers() != expected_titers || aCSR.row_offsets()[0] != 0 || aCSR.row_offsets()[aCSR.number_of_antigens()] != expected_titers) {
+        fmt::print(stderr, "{}: {} titers, expected {}\n", aName, aCSR.number_of_titers(), expected_titers);
+        return 1;
+    }
+    for (size_t ag_no = 0; ag_no < aExpected.size(); ++ag_no) {
+        const auto [first, last] = aCSR.row(hidb::AntigenIndex{ag_no});
+        const auto& expected = aExpected[ag_no];
+        bool same = (last - first) == expected.size();
+        for (size_t pos = first; same && pos < last; ++pos) {
+            const auto& [serum, table, titer] = expected[pos - first];
+            same = aCSR.sera()[pos] == serum && aCSR.tables()[pos] == table && aCSR.titers()[pos] == titer;
+        }
+        if (!same) {
+            fmt::print(stderr, "{}: row of antigen {} differs, {} titers, expected {}\n", aName, ag_no, last - first, expected.size());
+            return 1;
+        }
+    }
+    return 0;
+
+} // check
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -0,0 +1,132 @@
+#include <chrono>
+#include <numeric>
+
+#include "acmacs-base/argv.hh"
+#include "hidb-5/hidb.hh"
+
+// ----------------------------------------------------------------------
+
+using tables_t = std::vector<const hidb::bin::Table*>; // raw records, decoding does not depend on the titer order (see hidb::HiDb::titers_in_index_order())
+
+static size_t decode_naive(const tables_t& tables, std::vector<hidb::bin::titer_t>& target);
+static size_t decode(const tables_t& tables, std::vector<hidb::bin::titer_t>& target, hidb::bin::titer_decoder decoder);
+
+// ----------------------------------------------------------------------
+
+using namespace acmacs::argv;
+struct Options : public argv
+{
+    Options(int a_argc, const char* const a_argv[], on_error on_err = on_error::exit) : argv() { parse(a_argc, a_argv, on_err); }
+
+    option<size_t> repeat{*this, "repeat", dflt{5UL}, desc{"number of runs of each decoder, the best time is reported"}};
+
+    argument<str> hidb_file{*this, arg_name{"hidb5.hidb5b"}, mandatory};
+};
+
+int main(int argc, char* const argv[])
+{
+    try {
+        Options opt(argc, argv);
+        hidb::HiDb hidb(opt.hidb_file);
+        const auto hidb_tables = hidb::bin::tables(hidb.data());
+        tables_t tables;
+        size_t number_of_titers = 0;
+        for (size_t table_no = 0; table_no < hidb_tables.size(); ++table_no) {
+            tables.push_back(&hidb_tables[table_no]);
+            number_of_titers += hidb_tables[table_no].number_of_antigens() * hidb_tables[table_no].number_of_sera();
+        }
+        fmt::print("tables: {}  titers: {}\n", tables.size(), number_of_titers);
+
+        std::vector<hidb::bin::titer_t> expected(number_of_titers), decoded(number_of_titers);
+        const auto run = [&opt](std::string_view name, auto&& func) {
+            double best = 0.0;
+            for (size_t run_no = 0; run_no < *opt.repeat; ++run_no) {
+                const auto start = std::chrono::steady_clock::now();
+                func();
+                const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                if (run_no == 0 || elapsed.count() < best)
+                    best = elapsed.count();
+            }
+            fmt::print("{:<10s} {:10.6f}s\n", name, best);
+        };
+
+        run("std::stoi", [&]() { decode_naive(tables, expected); });
+        for (auto decoder : {hidb::bin::titer_decoder::scalar, hidb::bin::titer_decoder::sse2, hidb::bin::titer_decoder::avx2}) {
+            if (hidb::bin::available(decoder)) {
+                run(hidb::bin::to_string(decoder), [&]() { decode(tables, decoded, decoder); });
+                if (decoded != expected) {
+                    const auto mismatches = std::inner_product(decoded.begin(), decoded.end(), expected.begin(), 0UL, std::plus<>{}, [](auto d1, auto d2) { return d1 == d2 ? 0UL : 1UL; });
+                    AD_ERROR("{} decoder: {} titers differ from std::stoi", hidb::bin::to_string(decoder), mismatches);
+                }
+            }
+            else
+                fmt::print("{:<10s} not supported by cpu\n", hidb::bin::to_string(decoder));
+        }
+        return 0;
+    }
+    catch (std::exception& err) {
+        fmt::print(stderr, "ERROR: {}\n", err);
+        return 1;
+    }
+}
+
+// ----------------------------------------------------------------------
+
+size_t decode_naive(const tables_t& tables, std::vector<hidb::bin::titer_t>& target)
+{
+    auto parse = [](std::string_view text) -> hidb::bin::titer_t {
+        std::string titer{text};
+        if (titer.empty() || titer[0] == '*')
+            return hidb::bin::titer_t{};
+        auto type = hidb::bin::titer_t::regular;
+        switch (titer[0]) {
+            case '<':
+                type = hidb::bin::titer_t::less_than;
+                titer.erase(0, 1);
+                break;
+            case '>':
+                type = hidb::bin::titer_t::more_than;
+                titer.erase(0, 1);
+                break;
+            case '~':
+                type = hidb::bin::titer_t::dodgy;
+                titer.erase(0, 1);
+                break;
+        }
+        try {
+            if (const auto value = std::stoi(titer); value > 0)
+                return hidb::bin::titer_t::from_value(type, static_cast<size_t>(value));
+        }
+        catch (std::exception&) {
+        }
+        return hidb::bin::titer_t{};
+    };
+
+    auto* out = target.data();
+    for (const auto& table : tables) {
+        for (size_t ag_no = 0; ag_no < table->number_of_antigens(); ++ag_no) {
+            for (size_t sr_no = 0; sr_no < table->number_of_sera(); ++sr_no)
+                *out++ = parse(table->titer(ag_no, sr_no));
+        }
+    }
+    return static_cast<size_t>(out - target.data());
+
+} // decode_naive
+
+// ----------------------------------------------------------------------
+
+size_t decode(const tables_t& tables, std::vector<hidb::bin::titer_t>& target, hidb::bin::titer_decoder decoder)
+{
+    auto* out = target.data();
+    for (const auto* table : tables) {
+        hidb::bin::decode_titers(*table, out, decoder);
+        out += table->number_of_antigens() * table->number_of_sera();
+    }
+    return static_cast<size_t>(out - target.data());
+
+} // decode
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
@@ -0,0 +1,41 @@
+#include "acmacs-base/argv.hh"
+#include "acmacs-base/timeit.hh"
+#include "hidb-5/hidb-titers-csr.hh"
+
+// ----------------------------------------------------------------------
+
+using namespace acmacs::argv;
+struct Options : public argv
+{
+    Options(int a_argc, const char* const a_argv[], on_error on_err = on_error::exit) : argv() { parse(a_argc, a_argv, on_err); }
+
+    option<size_t> threads{*this, "threads", dflt{0UL}, desc{"number of threads, 0 - number of cpus"}};
+    option<bool> verbose{*this, 'v', "verbose"};
+
+    argument<str> hidb_file{*this, arg_name{"hidb5.hidb5b"}, mandatory};
+    argument<str> output{*this, arg_name{"output.hidb5csr"}, mandatory};
+};
+
+int main(int argc, char* const argv[])
+{
+    try {
+        Options opt(argc, argv);
+        hidb::HiDb hidb(opt.hidb_file, opt.verbose);
+        Timeit ti("making titers csr: ", do_report_time(opt.verbose));
+        const hidb::TitersCSR csr(hidb, opt.threads);
+        ti.report();
+        if (opt.verbose)
+            fmt::print(stderr, "antigens: {}  sera: {}  tables: {}  titers: {}\n", csr.number_of_antigens(), csr.number_of_sera(), csr.number_of_tables(), csr.number_of_titers());
+        csr.save(opt.output);
+        return 0;
+    }
+    catch (std::exception& err) {
+        fmt::print(stderr, "ERROR: {}\n", err);
+        return 1;
+    }
+}
+
+// ----------------------------------------------------------------------
+/// Local Variables:
+/// eval: (if (fboundp 'eu-rename-buffer) (eu-rename-buffer))
+/// End:
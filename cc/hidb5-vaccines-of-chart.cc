@@ -11,6 +11,7 @@ struct Options : public argv
     Options(int a_argc, const char* const a_argv[], on_error on_err = on_error::exit) : argv() { parse(a_argc, a_argv, on_err); }
 
     option<str> db_dir{*this, "db-dir"};
+    option<bool> fold_drop{*this, "fold-drop", desc{"report fold drop of test antigens against homologous sera"}};
 
     argument<str> chart_file{*this, arg_name{"chart"}, mandatory};
 };
@@ -24,7 +25,7 @@ int main(int argc, char* const argv[])
         auto chart = acmacs::chart::import_from_file(opt.chart_file);
         if (chart->info()->virus_type(acmacs::chart::Info::Compute::Yes).empty())
             throw std::runtime_error("chart has no virus_type");
-        auto vaccines = hidb::vaccines(*chart);
+        auto vaccines = hidb::vaccines(*chart, opt.fold_drop ? hidb::vaccines_fold_drop::yes : hidb::vaccines_fold_drop::no);
         fmt::print("{}\n", vaccines.report(hidb::Vaccines::ReportConfig{}.vaccine_sep("\n").show_no(false)));
         return 0;
     }
@@ -73,14 +73,15 @@ std::string hidb::report_tables(const hidb::HiDb& hidb, const TableIndexList& aT
     fmt::memory_buffer out;
     if (aReportTables != report_tables::none) {
         auto hidb_tables = hidb.tables();
-        const auto by_lab_assay = hidb_tables->sorted(aTables, lab_assay_rbc_table_t::recent_first);
+        const auto tables = bin::tables(hidb.data());
+        const auto by_lab_assay = hidb_tables->grouped(aTables, lab_assay_rbc_table_t::recent_first);
         if (!by_lab_assay.empty()) {
             switch (aReportTables) {
                 case report_tables::all:
-                    for (auto entry : by_lab_assay) {
+                    for (const auto& entry : by_lab_assay) {
                         fmt::format_to_mb(out, "{}{}:{} ({})", aPrefix, entry.lab, assay(entry.assay), entry.tables.size());
-                        for (auto table : entry.tables)
-                            fmt::format_to_mb(out, " {}:{}", table->date(), rbc(entry.assay, entry.rbc));
+                        for (const auto table_index : entry.tables)
+                            fmt::format_to_mb(out, " {}:{}", tables[*table_index].date(), rbc(entry.assay, entry.rbc));
                         fmt::format_to_mb(out, "\n");
                     }
                     // if (by_lab_assay.size() > 1)
@@ -88,13 +89,13 @@ std::string hidb::report_tables(const hidb::HiDb& hidb, const TableIndexList& aT
                     break;
                 case report_tables::oldest:
                     // fmt::format_to_mb(out, "{}Tables:{}\n", aPrefix, tables.size());
-                    for (auto entry : by_lab_assay)
-                        fmt::format_to_mb(out, "{}{}:{} ({})  oldest:{}", aPrefix, entry.lab, assay(entry.assay), entry.tables.size(), entry.tables.back()->name());
+                    for (const auto& entry : by_lab_assay)
+                        fmt::format_to_mb(out, "{}{}:{} ({})  oldest:{}", aPrefix, entry.lab, assay(entry.assay), entry.tables.size(), hidb_tables->at(entry.tables.back())->name());
                     break;
                 case report_tables::recent:
                     // fmt::format_to_mb(out, "{}Tables:{}\n", aPrefix, tables.size());
-                    for (auto entry : by_lab_assay)
-                        fmt::format_to_mb(out, "{}{}:{} ({})  recent:{}", aPrefix, entry.lab, assay(entry.assay), entry.tables.size(), entry.tables.front()->name());
+                    for (const auto& entry : by_lab_assay)
+                        fmt::format_to_mb(out, "{}{}:{} ({})  recent:{}", aPrefix, entry.lab, assay(entry.assay), entry.tables.size(), hidb_tables->at(entry.tables.front())->name());
                     break;
                 case report_tables::none:
                     break;
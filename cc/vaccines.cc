@@ -2,6 +2,7 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <iterator>
 
 #include "acmacs-chart-2/chart-modify.hh"
 #include "hidb-5/hidb.hh"
@@ -9,7 +10,11 @@
 
 // ----------------------------------------------------------------------
 
-hidb::VaccinesOfChart hidb::vaccines(const acmacs::chart::Chart& aChart)
+static void add_fold_drops(const std::vector<hidb::Vaccines::Entry*>& aEntries, const acmacs::chart::Chart& aChart, const hidb::HiDb& aHiDb);
+
+// ----------------------------------------------------------------------
+
+hidb::VaccinesOfChart hidb::vaccines(const acmacs::chart::Chart& aChart, vaccines_fold_drop aFoldDrop)
 {
     const auto virus_type = aChart.info()->virus_type(acmacs::chart::Info::Compute::Yes);
     const auto& hidb = hidb::get(virus_type);
@@ -36,12 +41,100 @@ hidb::VaccinesOfChart hidb::vaccines(const acmacs::chart::Chart& aChart)
         vaccines.sort();
     }
 
+    if (aFoldDrop == vaccines_fold_drop::yes) {
+        std::vector<hidb::Vaccines::Entry*> entries;
+        for (auto& vaccines : result) {
+            for (auto& entries_of_passage_type : vaccines.mEntries)
+                std::transform(entries_of_passage_type.begin(), entries_of_passage_type.end(), std::back_inserter(entries), [](auto& entry) { return &entry; });
+        }
+        add_fold_drops(entries, aChart, hidb);
+    }
+
     return result;
 
 } // hidb::vaccines
 
 // ----------------------------------------------------------------------
 
+void add_fold_drops(const std::vector<hidb::Vaccines::Entry*>& aEntries, const acmacs::chart::Chart& aChart, const hidb::HiDb& aHiDb)
+{
+    auto hidb_antigens = aHiDb.antigens();
+    auto chart_antigens = aChart.antigens();
+
+      // test antigens of the chart found in hidb, then vaccine antigens
+      // test antigens are found in one pass with passage_strictness::ignore_if_empty, as vaccine antigens are found by vaccines()
+    acmacs::chart::Indexes candidates; // distinct antigens are not stored in hidb
+    for (size_t ag_no = 0; ag_no < chart_antigens->size(); ++ag_no) {
+        if (auto antigen = (*chart_antigens)[ag_no]; !antigen->reference() && !antigen->annotations().distinct())
+            candidates.push_back(ag_no);
+    }
+    std::vector<size_t> test_antigens; // chart antigen indexes
+    hidb::AntigenIndexList antigens;
+    const auto found = hidb_antigens->find_all(*chart_antigens, candidates, hidb::passage_strictness::ignore_if_empty);
+    for (size_t candidate_no = 0; candidate_no < found.size(); ++candidate_no) {
+        if (found[candidate_no].has_value()) {
+            test_antigens.push_back(candidates[candidate_no]);
+            antigens.push_back(*found[candidate_no]);
+        }
+    }
+
+    struct vaccine_serum_t
+    {
+        hidb::Vaccines::HomologousSerum* serum;
+        size_t vaccine_chart_antigen_index;
+        size_t antigen_no; // in antigens
+        size_t serum_no;   // in sera
+    };
+    std::vector<vaccine_serum_t> vaccine_sera;
+    hidb::SerumIndexList sera;
+    for (auto* entry : aEntries) { // vaccine antigens and their homologous sera were found in hidb by vaccines()
+        antigens.push_back(entry->hidb_antigen->ref().index());
+        for (auto& homologous_serum : entry->homologous_sera) {
+            sera.push_back(homologous_serum.hidb_serum->ref().index());
+            vaccine_sera.push_back(vaccine_serum_t{&homologous_serum, entry->chart_antigen_index, antigens.size() - 1, sera.size() - 1});
+        }
+    }
+
+      // titers of all antigens against all vaccine sera in one pass over hidb tables
+    const auto titers = aHiDb.titers(antigens, sera);
+
+    for (const auto& vaccine_serum : vaccine_sera) {
+        const auto& homologous = titers[vaccine_serum.antigen_no * sera.size() + vaccine_serum.serum_no];
+        if (homologous.empty())
+            continue;
+        for (size_t test_no = 0; test_no < test_antigens.size(); ++test_no) {
+            if (test_antigens[test_no] == vaccine_serum.vaccine_chart_antigen_index)
+                continue;
+            const auto& test = titers[test_no * sera.size() + vaccine_serum.serum_no];
+            hidb::Vaccines::HomologousSerum::FoldDrop fold_drop{test_antigens[test_no], 0, 0.0, 0.0};
+              // both are sorted by table index
+            for (auto hom = homologous.begin(), tst = test.begin(); hom != homologous.end() && tst != test.end();) {
+                if (hom->table < tst->table)
+                    ++hom;
+                else if (tst->table < hom->table)
+                    ++tst;
+                else {
+                    if (!hom->titer.is_dont_care() && !tst->titer.is_dont_care()) {
+                        const auto drop = hom->titer.logged_with_thresholded() - tst->titer.logged_with_thresholded();
+                        fold_drop.max = fold_drop.number_of_tables == 0 ? drop : std::max(fold_drop.max, drop);
+                        fold_drop.mean += drop;
+                        ++fold_drop.number_of_tables;
+                    }
+                    ++hom;
+                    ++tst;
+                }
+            }
+            if (fold_drop.number_of_tables > 0) {
+                fold_drop.mean /= static_cast<double>(fold_drop.number_of_tables);
+                vaccine_serum.serum->fold_drops.push_back(fold_drop);
+            }
+        }
+    }
+
+} // add_fold_drops
+
+// ----------------------------------------------------------------------
+
 void hidb::update_vaccines(acmacs::chart::ChartModify& /*aChart*/, const VaccinesOfChart& vaccines)
 {
     AD_WARNING("hidb::update_vaccines not implemented (need to implemented sematic attributes first)");
@@ -128,8 +221,13 @@ std::string hidb::Vaccines::report(PassageType aPassageType, const Vaccines::Rep
         if (config.show_no_)
             fmt::format_to_mb(out, "{:2d} ", aNo);
         fmt::format_to_mb(out, "{:4d} \"{}\" tables:{} recent:{}\n", entry.chart_antigen_index, entry.chart_antigen->name_full(), entry.hidb_antigen->number_of_tables(), entry.most_recent_table->name());
-        for (const auto& hs: entry.homologous_sera)
+        for (const auto& hs: entry.homologous_sera) {
             fmt::format_to_mb(out, "{:{}c}      {} {} tables:{} recent:{}\n", ' ', config.indent_ + 2, hs.chart_serum->serum_id(), fmt::format("{: }", hs.chart_serum->annotations()), hs.hidb_serum->number_of_tables(), hs.most_recent_table->name());
+            if (!hs.fold_drops.empty()) {
+                const auto four_fold = std::count_if(hs.fold_drops.begin(), hs.fold_drops.end(), [](const auto& fd) { return fd.mean >= 2.0; });
+                fmt::format_to_mb(out, "{:{}c}        fold drop: test antigens:{} 4-fold-or-more:{}\n", ' ', config.indent_ + 2, hs.fold_drops.size(), four_fold);
+            }
+        }
     };
 
     const auto& entry = mEntries[static_cast<size_t>(aPassageType)];
@@ -39,6 +39,8 @@ namespace hidb
 
     class VaccinesOfChart;
 
+    enum class vaccines_fold_drop { no, yes };
+
     class Vaccines
     {
      public:
@@ -50,10 +52,21 @@ namespace hidb
             bool operator < (const HomologousSerum& a) const;
             size_t number_of_tables() const;
 
+              // titer of a test antigen of the chart against this serum vs. homologous titer (vaccine antigen against this serum) in the same hidb table
+              // test antigens are found in hidb with passage_strictness::ignore_if_empty, the same as vaccine antigens
+            struct FoldDrop
+            {
+                size_t chart_antigen_index;
+                size_t number_of_tables; // hidb tables with both titers
+                double mean;             // mean of log2(homologous titer / titer), 2.0 means 4-fold drop
+                double max;
+            };
+
             std::shared_ptr<acmacs::chart::Serum> chart_serum;
             size_t chart_serum_index;
             hidb::SerumP hidb_serum;
             std::shared_ptr<hidb::Table> most_recent_table;
+            std::vector<FoldDrop> fold_drops; // filled by vaccines(chart, vaccines_fold_drop::yes), sorted by chart_antigen_index
         };
 
         class Entry
@@ -148,7 +161,7 @@ namespace hidb
         acmacs::whocc::Vaccine mNameType;
         std::array<std::vector<Entry>, PassageTypeSize> mEntries;
 
-        friend VaccinesOfChart vaccines(const acmacs::chart::Chart&);
+        friend VaccinesOfChart vaccines(const acmacs::chart::Chart&, vaccines_fold_drop);
 
         static inline PassageType passage_type(const acmacs::chart::Antigen& aAntigen)
             {
@@ -187,7 +200,7 @@ namespace hidb
 
     // const std::vector<Vaccine>& vaccine_names(const acmacs::virus::type_subtype_t& aSubtype, std::string aLineage);
 
-    VaccinesOfChart vaccines(const acmacs::chart::Chart& aChart);
+    VaccinesOfChart vaccines(const acmacs::chart::Chart& aChart, vaccines_fold_drop aFoldDrop = vaccines_fold_drop::no);
 
     Vaccines* find_vaccines_in_chart(std::string aName, const acmacs::chart::Chart& aChart);
     void update_vaccines(acmacs::chart::ChartModify& aChart, const VaccinesOfChart& vaccines);